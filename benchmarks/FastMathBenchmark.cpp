@@ -0,0 +1,110 @@
+/*  Console check of the fast math kernels against the standard functions: worst case error over the input range
+ *  and block throughput. Built with -DSCYCLONE_BUILD_BENCHMARKS=ON, it measures the instruction set the compiler
+ *  flags select for FastMath.cpp.
+ */
+#include "FastMath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+    constexpr int blockSize = 512;
+    constexpr int numRepetitions = 20000;
+
+    const char* getInstructionSet() {
+#if defined (__AVX2__)
+        return "AVX2";
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        return "SSE2";
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+        return "NEON";
+#else
+        return "scalar";
+#endif
+    }
+
+    // every normal positive float, stepping through the bit patterns so each binade is covered evenly
+    double maxLog2Error() {
+        constexpr std::uint32_t firstNormal = 0x00800000, lastNormal = 0x7f7fffff, step = 61;
+        std::vector<float> input, output;
+        input.reserve((lastNormal - firstNormal) / step + 1);
+        for (std::uint32_t bits = firstNormal; bits <= lastNormal; bits += step) {
+            float x;
+            std::memcpy(&x, &bits, sizeof(x));
+            input.push_back(x);
+        }
+        output.resize(input.size());
+        utils::fastLog2(input.data(), output.data(), (int) input.size());
+
+        double maxError = 0.;
+        for (size_t i = 0; i < input.size(); ++i)
+            maxError = std::max(maxError, std::abs((double) output[i] - std::log2((double) input[i])));
+        return maxError;
+    }
+
+    double maxExp2Error() {
+        constexpr int numValues = 1 << 24;
+        std::vector<float> input((size_t) numValues), output((size_t) numValues);
+        for (int i = 0; i < numValues; ++i)
+            input[(size_t) i] = -126.f + 253.f * (float) i / (float) (numValues - 1);
+        utils::fastExp2(input.data(), output.data(), numValues);
+
+        double maxError = 0.;
+        for (int i = 0; i < numValues; ++i) {
+            const double expected = std::exp2((double) input[(size_t) i]);
+            maxError = std::max(maxError, std::abs((double) output[(size_t) i] - expected) / expected);
+        }
+        return maxError;
+    }
+
+    // millions of values per second over repeated blocks, the output is summed so nothing is optimised away
+    template <typename Function>
+    double measureThroughput(const std::vector<float>& input, Function&& function, float& checksum) {
+        std::vector<float> output(input.size());
+        const auto start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < numRepetitions; ++repetition) {
+            function(input.data(), output.data(), (int) input.size());
+            checksum += output[(size_t) repetition % output.size()];
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return (double) input.size() * numRepetitions / elapsed.count() * 1e-6;
+    }
+
+    void printThroughput(const char* name, const std::vector<float>& input,
+                         void (*fast)(const float*, float*, int), float (*reference)(float)) {
+        float checksum = 0.f;
+        const double fastRate = measureThroughput(input, fast, checksum);
+        const double referenceRate = measureThroughput(input, [reference](const float* in, float* out, int n) {
+            for (int i = 0; i < n; ++i)
+                out[i] = reference(in[i]);
+        }, checksum);
+
+        std::printf("%-6s fast %8.1f M/s   std %8.1f M/s   speed-up %5.2fx   (checksum %g)\n",
+                    name, fastRate, referenceRate, fastRate / referenceRate, (double) checksum);
+    }
+}
+
+int main() {
+    std::printf("instruction set: %s\n\n", getInstructionSet());
+
+    std::printf("log2 max absolute error: %.3g\n", maxLog2Error());
+    std::printf("exp2 max relative error: %.3g\n\n", maxExp2Error());
+
+    // the ranges the signal chain converts: levels from silence floor to above full scale, and dB / 6.02 gains
+    std::vector<float> levels(blockSize), exponents(blockSize);
+    for (int i = 0; i < blockSize; ++i) {
+        levels[(size_t) i] = std::exp2(-30.f + 32.f * (float) i / blockSize);
+        exponents[(size_t) i] = -20.f + 24.f * (float) i / blockSize;
+    }
+
+    using FastBlock = void (*)(const float*, float*, int);
+    using Reference = float (*)(float);
+    printThroughput("log2", levels, static_cast<FastBlock>(utils::fastLog2), static_cast<Reference>(std::log2));
+    printThroughput("exp2", exponents, static_cast<FastBlock>(utils::fastExp2), static_cast<Reference>(std::exp2));
+    return 0;
+}
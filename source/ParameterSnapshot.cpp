@@ -0,0 +1,41 @@
+#include "ParameterSnapshot.h"
+
+ParameterSnapshotSource::ParameterSnapshotSource(juce::AudioProcessorValueTreeState &apvts) {
+    for (size_t i = 0; i < rawValues.size(); ++i) {
+        rawValues[i] = apvts.getRawParameterValue(PluginParameters::PARAMETER_IDS[i].getParamID());
+        jassert (rawValues[i] != nullptr);
+    }
+}
+
+void ParameterSnapshotSource::capture(ParameterSnapshot &snapshot) const {
+    using P = PluginParameters;
+
+    snapshot.inputGain = load(P::INPUT_GAIN);
+
+    for (size_t i = 0; i < snapshot.networks.size(); ++i) {
+        const auto& indices = P::NETWORK_INDICES[i];
+        auto& network = snapshot.networks[i];
+
+        network.transientAttackTime = load(indices.tranAttackTime);
+        network.transientShaper = load(indices.tranShaper);
+        network.filter = load(indices.filter);
+        network.grainOnOff = load(indices.grainOnOff) >= 0.5f;
+        network.onOff = load(indices.onOff) >= 0.5f;
+        network.grainInterval = load(indices.grainInterval);
+        network.grainSize = load(indices.grainSize);
+        network.grainPitch = load(indices.grainPitch);
+        network.grainMix = load(indices.grainMix);
+    }
+
+    snapshot.fade = load(P::FADE);
+    snapshot.compDryWet = load(P::COMP_DRY_WET);
+    snapshot.compThreshold = load(P::COMP_THRESHOLD);
+    snapshot.compRatio = load(P::COMP_RATIO);
+    snapshot.compMakeUpGain = load(P::COMP_MAKEUPGAIN);
+    snapshot.outputGain = load(P::OUTPUT_GAIN);
+    snapshot.dryWet = load(P::DRY_WET);
+}
+
+float ParameterSnapshotSource::load(PluginParameters::ParameterIndex index) const {
+    return rawValues[index]->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#ifndef VAESYNTH_PARAMETERSNAPSHOT_H
+#define VAESYNTH_PARAMETERSNAPSHOT_H
+
+#include <JuceHeader.h>
+#include "PluginParameters.h"
+
+struct NetworkParameterSnapshot {
+    float transientAttackTime = 0.5f;
+    float transientShaper = 0.5f;
+    float filter = 0.5f;
+    bool grainOnOff = false;
+    bool onOff = false;
+    float grainInterval = 0.5f;
+    float grainSize = 60.f;
+    float grainPitch = 0.f;
+    float grainMix = 0.5f;
+};
+
+// plain copy of every automatable parameter, taken once at the top of processBlock
+struct ParameterSnapshot {
+    float inputGain = 0.f;
+    std::array<NetworkParameterSnapshot, PluginParameters::NUM_NETWORKS> networks;
+    float fade = 0.5f;
+    float compDryWet = 0.f;
+    float compThreshold = 0.f;
+    float compRatio = 1.f;
+    float compMakeUpGain = 0.f;
+    float outputGain = 0.f;
+    float dryWet = 1.f;
+};
+
+/*  Resolves the raw parameter values once by index, so capturing a snapshot is a fixed number of relaxed atomic
+ *  loads without any string lookup. Safe to call on the audio thread.
+ */
+class ParameterSnapshotSource {
+public:
+    explicit ParameterSnapshotSource(juce::AudioProcessorValueTreeState& apvts);
+
+    void capture(ParameterSnapshot& snapshot) const;
+
+private:
+    float load(PluginParameters::ParameterIndex index) const;
+
+    std::array<std::atomic<float>*, PluginParameters::NUM_PARAMETERS> rawValues {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSnapshotSource)
+};
+
+#endif //VAESYNTH_PARAMETERSNAPSHOT_H
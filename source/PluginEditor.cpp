@@ -4,7 +4,7 @@
 
 //==============================================================================
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor& p, juce::AudioProcessorValueTreeState& parameters)
-    : AudioProcessorEditor (&p), apvts(parameters), processorRef (p), transientViewer(p), openGLBackground(parameters, p), advancedParameterControl(parameters), parameterControl(parameters)
+    : AudioProcessorEditor (&p), apvts(parameters), processorRef (p), transientViewer(p), openGLBackground(parameters, p), advancedParameterControl(parameters), parameterControl(parameters), diagnosticsView(p)
 {
     juce::ignoreUnused (processorRef);
 
@@ -39,6 +39,8 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     addAndMakeVisible(parameterControl);
     addAndMakeVisible(transientViewer);
     addAndMakeVisible(textureComponent);
+    addChildComponent(diagnosticsView);
+    setWantsKeyboardFocus(true);
     bool state = processorRef.advancedParameterControlVisible.getValue();
 
     headerComponent->detailButton.setToggleState(state, juce::sendNotification);
@@ -103,11 +105,23 @@ void AudioPluginAudioProcessorEditor::resized()
     parameterControl.setBounds(areaParameter);
     headerComponent->setBounds(getLocalBounds());
     textureComponent.setBounds(getLocalBounds());
+    diagnosticsView.setBounds(getLocalBounds().reduced(40));
 
     processorRef.onNetwork1NameChange(processorRef.network1Name.toString());
     processorRef.onNetwork2NameChange(processorRef.network2Name.toString());
 }
 
+bool AudioPluginAudioProcessorEditor::keyPressed(const juce::KeyPress &key) {
+    // cmd/ctrl + shift + D toggles the diagnostics overlay
+    if (key == juce::KeyPress('d', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0)) {
+        diagnosticsView.setVisible(! diagnosticsView.isVisible());
+        if (diagnosticsView.isVisible())
+            diagnosticsView.toFront(false);
+        return true;
+    }
+    return false;
+}
+
 void AudioPluginAudioProcessorEditor::parameterChanged(const juce::String &parameterID, float newValue) {
     parameterControl.parameterChanged(parameterID, newValue);
     if (parameterID == PluginParameters::SELECT_NETWORK1_ID.getParamID() && newValue == 1.f) {
@@ -9,6 +9,7 @@
 #include "ui/CustomComponents/AdvancedParameterControl/AdvancedParameterControl.h"
 #include "ui/CustomComponents/Header/HeaderComponent.h"
 #include "ui/CustomComponents/Texture/TextureComponent.h"
+#include "ui/CustomComponents/Diagnostics/DiagnosticsView.h"
 #include "ui/LookAndFeel/CustomFontLookAndFeel.h"
 
 //==============================================================================
@@ -21,6 +22,7 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    bool keyPressed (const juce::KeyPress& key) override;
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
 private:
@@ -39,6 +41,7 @@ private:
     AdvancedParameterControl advancedParameterControl;
     std::unique_ptr<HeaderComponent> headerComponent;
     TextureComponent textureComponent;
+    DiagnosticsView diagnosticsView;
 
     CustomFontLookAndFeel customFontLookAndFeel;
 
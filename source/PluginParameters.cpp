@@ -175,6 +175,7 @@ juce::ValueTree PluginParameters::createNotAutomatableParameterLayout()
     notAutomatableParameters.setProperty(ADVANCED_PARAMETER_CONTROL_VISIBLE_NAME, juce::var(false), nullptr);
     notAutomatableParameters.setProperty(NETWORK1_NAME_NAME, juce::var("Funk"), nullptr);
     notAutomatableParameters.setProperty(NETWORK2_NAME_NAME, juce::var("Djembe"), nullptr);
+    notAutomatableParameters.setProperty(PARALLEL_BRANCH_PROCESSING_NAME, juce::var(false), nullptr);
     return notAutomatableParameters;
 }
 
@@ -182,6 +183,7 @@ void PluginParameters::removeNotAutomatableParameterLayout(juce::ValueTree notAu
     notAutomatableParameters.removeProperty(ADVANCED_PARAMETER_CONTROL_VISIBLE_NAME, nullptr);
     notAutomatableParameters.removeProperty(NETWORK1_NAME_NAME, nullptr);
     notAutomatableParameters.removeProperty(NETWORK2_NAME_NAME, nullptr);
+    notAutomatableParameters.removeProperty(PARALLEL_BRANCH_PROCESSING_NAME, nullptr);
 }
 
 juce::StringArray PluginParameters::getPluginParameterList() {
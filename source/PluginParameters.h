@@ -92,9 +92,110 @@ public:
             // not automatable parameters
             ADVANCED_PARAMETER_CONTROL_VISIBLE_NAME = "advanced_parameter_control_visible",
             NETWORK1_NAME_NAME = "network1_name",
-            NETWORK2_NAME_NAME = "network2_name"
+            NETWORK2_NAME_NAME = "network2_name",
+            PARALLEL_BRANCH_PROCESSING_NAME = "parallel_branch_processing"
             ;
 
+    // dense index of every automatable parameter, in the order of the IDs above
+    enum ParameterIndex : size_t {
+        INPUT_GAIN,
+        TRAN_ATTACK_TIME_NETWORK1,
+        TRAN_ATTACK_TIME_NETWORK2,
+        TRAN_SHAPER_NETWORK1,
+        FILTER_NETWORK1,
+        TRAN_SHAPER_NETWORK2,
+        FILTER_NETWORK2,
+        SELECT_NETWORK1,
+        GRAIN_ON_OFF_NETWORK1,
+        ON_OFF_NETWORK1,
+        SELECT_NETWORK2,
+        GRAIN_ON_OFF_NETWORK2,
+        ON_OFF_NETWORK2,
+        GRAIN_NETWORK1_INTERVAL,
+        GRAIN_NETWORK1_SIZE,
+        GRAIN_NETWORK1_PITCH,
+        GRAIN_NETWORK1_MIX,
+        GRAIN_NETWORK2_INTERVAL,
+        GRAIN_NETWORK2_SIZE,
+        GRAIN_NETWORK2_PITCH,
+        GRAIN_NETWORK2_MIX,
+        FADE,
+        COMP_DRY_WET,
+        COMP_THRESHOLD,
+        COMP_RATIO,
+        COMP_MAKEUPGAIN,
+        OUTPUT_GAIN,
+        DRY_WET,
+        NUM_PARAMETERS
+    };
+
+    inline static const std::array<juce::ParameterID, NUM_PARAMETERS> PARAMETER_IDS = {
+            INPUT_GAIN_ID,
+            TRAN_ATTACK_TIME_NETWORK1_ID, TRAN_ATTACK_TIME_NETWORK2_ID,
+            TRAN_SHAPER_NETWORK1_ID, FILTER_NETWORK1_ID, TRAN_SHAPER_NETWORK2_ID, FILTER_NETWORK2_ID,
+            SELECT_NETWORK1_ID, GRAIN_ON_OFF_NETWORK1_ID, ON_OFF_NETWORK1_ID,
+            SELECT_NETWORK2_ID, GRAIN_ON_OFF_NETWORK2_ID, ON_OFF_NETWORK2_ID,
+            GRAIN_NETWORK1_INTERVAL_ID, GRAIN_NETWORK1_SIZE_ID, GRAIN_NETWORK1_PITCH_ID, GRAIN_NETWORK1_MIX_ID,
+            GRAIN_NETWORK2_INTERVAL_ID, GRAIN_NETWORK2_SIZE_ID, GRAIN_NETWORK2_PITCH_ID, GRAIN_NETWORK2_MIX_ID,
+            FADE_ID,
+            COMP_DRY_WET_ID, COMP_THRESHOLD_ID, COMP_RATIO_ID, COMP_MAKEUPGAIN_ID,
+            OUTPUT_GAIN_ID, DRY_WET_ID
+    };
+
+    // The engine (slots, buses, lanes, mixer) is sized by this constant, but the parameter IDs below, the fade and
+    // the two editor panels are written out for exactly two networks. Raising it needs a new parameter layout first.
+    static constexpr int NUM_NETWORKS = 2;
+
+    struct NetworkParameterIndices {
+        ParameterIndex tranAttackTime;
+        ParameterIndex tranShaper;
+        ParameterIndex filter;
+        ParameterIndex select;
+        ParameterIndex grainOnOff;
+        ParameterIndex onOff;
+        ParameterIndex grainInterval;
+        ParameterIndex grainSize;
+        ParameterIndex grainPitch;
+        ParameterIndex grainMix;
+    };
+
+    static constexpr std::array<NetworkParameterIndices, NUM_NETWORKS> NETWORK_INDICES = {{
+            {TRAN_ATTACK_TIME_NETWORK1, TRAN_SHAPER_NETWORK1, FILTER_NETWORK1, SELECT_NETWORK1,
+             GRAIN_ON_OFF_NETWORK1, ON_OFF_NETWORK1, GRAIN_NETWORK1_INTERVAL, GRAIN_NETWORK1_SIZE,
+             GRAIN_NETWORK1_PITCH, GRAIN_NETWORK1_MIX},
+            {TRAN_ATTACK_TIME_NETWORK2, TRAN_SHAPER_NETWORK2, FILTER_NETWORK2, SELECT_NETWORK2,
+             GRAIN_ON_OFF_NETWORK2, ON_OFF_NETWORK2, GRAIN_NETWORK2_INTERVAL, GRAIN_NETWORK2_SIZE,
+             GRAIN_NETWORK2_PITCH, GRAIN_NETWORK2_MIX}
+    }};
+
+    struct NetworkParameterIDs {
+        juce::ParameterID tranAttackTime;
+        juce::ParameterID tranShaper;
+        juce::ParameterID filter;
+        juce::ParameterID select;
+        juce::ParameterID grainOnOff;
+        juce::ParameterID onOff;
+        juce::ParameterID grainInterval;
+        juce::ParameterID grainSize;
+        juce::ParameterID grainPitch;
+        juce::ParameterID grainMix;
+    };
+
+    // per network parameter IDs, indexed by network number - 1
+    inline static const std::array<NetworkParameterIDs, NUM_NETWORKS> NETWORK_IDS = {{
+            {TRAN_ATTACK_TIME_NETWORK1_ID, TRAN_SHAPER_NETWORK1_ID, FILTER_NETWORK1_ID, SELECT_NETWORK1_ID,
+             GRAIN_ON_OFF_NETWORK1_ID, ON_OFF_NETWORK1_ID, GRAIN_NETWORK1_INTERVAL_ID, GRAIN_NETWORK1_SIZE_ID,
+             GRAIN_NETWORK1_PITCH_ID, GRAIN_NETWORK1_MIX_ID},
+            {TRAN_ATTACK_TIME_NETWORK2_ID, TRAN_SHAPER_NETWORK2_ID, FILTER_NETWORK2_ID, SELECT_NETWORK2_ID,
+             GRAIN_ON_OFF_NETWORK2_ID, ON_OFF_NETWORK2_ID, GRAIN_NETWORK2_INTERVAL_ID, GRAIN_NETWORK2_SIZE_ID,
+             GRAIN_NETWORK2_PITCH_ID, GRAIN_NETWORK2_MIX_ID}
+    }};
+
+    static const NetworkParameterIDs& getNetworkIDs(int networkNumber) {
+        jassert (networkNumber >= 1 && networkNumber <= NUM_NETWORKS);
+        return NETWORK_IDS[(size_t) (networkNumber - 1)];
+    }
+
     static juce::StringArray getPluginParameterList();
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     static juce::ValueTree createNotAutomatableParameterLayout();
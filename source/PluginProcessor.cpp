@@ -12,52 +12,47 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                      #endif
                        ),
         parameters (*this, nullptr, juce::Identifier ("Scyclone"), PluginParameters::createParameterLayout()),
-        processorTransientSplitter1(parameters, 1),
-        processorTransientSplitter2(parameters, 2),
-        iirCutoffFilter1(parameters, 1),
-        iirCutoffFilter2(parameters, 2),
-        onnxProcessor1(parameters, 1, FunkDrum),
-        onnxProcessor2(parameters, 2, Djembe),
-        grainDelay1(1),
-        grainDelay2(2),
+        parameterSnapshotSource(parameters),
         processorCompressor(parameters)
 {
+    for (size_t i = 0; i < networkSlots.size(); ++i) {
+        const int networkNumber = (int) i + 1;
+        networkSlots[i] = std::make_unique<NetworkSlot>(parameters, networkNumber, getDefaultModel(networkNumber), eventLog, stageProfiler);
+
+        networkSlots[i]->onModelLoad = [this, networkNumber] (bool initLoading, juce::String modelName) {
+            // processing is still suspended here, so the delays can be changed before it resumes
+            if (!initLoading)
+                updateLatency();
+            this->suspendProcessing(initLoading);
+            if (!initLoading && modelName != "") {
+                setExternalModelName(networkNumber, modelName);
+            }
+        };
+    }
 
     network1Name = "Funk";
     network2Name = "Djembe";
 
-    for (auto & parameterID : PluginParameters::getPluginParameterList()) {
-        parameters.addParameterListener(parameterID, this);
+    for (auto & networkIDs : PluginParameters::NETWORK_IDS) {
+        parameters.addParameterListener(networkIDs.select.getParamID(), this);
     }
 
     parameters.state.addChild(PluginParameters::createNotAutomatableParameterLayout(), 0, nullptr);
-    
-    dryWetMixer.setDryWetProportion(parameters.getRawParameterValue(PluginParameters::DRY_WET_ID.getParamID())->load());
-    compMixer.setDryWetProportion(parameters.getRawParameterValue(PluginParameters::COMP_DRY_WET_ID.getParamID())->load());
-    fadeMixer.setDryWetProportion(parameters.getRawParameterValue(PluginParameters::FADE_ID.getParamID())->load());
-    
-    onnxProcessor1.onOnnxModelLoad = [this] (bool initLoading, juce::String modelName) {
-        this->suspendProcessing(initLoading);
-//        std::cout << "Onnx proc 1 suspend:" << initLoading << std::endl; //DBG
-        if (!initLoading && modelName != "") {
-            setExternalModelName(1, modelName);
-        }
-    };
-    onnxProcessor2.onOnnxModelLoad = [this] (bool initLoading, juce::String modelName) {
-        this->suspendProcessing(initLoading);
-//        std::cout << "Onnx proc 2 suspend:" << initLoading << std::endl; //DBG
-        if (!initLoading && modelName != "") {
-            setExternalModelName(2, modelName);
-        }
-    };
 
-    setInitialMuteParameters();
-    initialiseRnbo();
+    parallelBranchProcessing.addListener(this);
+    parallelBranchProcessing.referTo(parameters.state.getChildWithName("Settings")
+                                                .getPropertyAsValue(PluginParameters::PARALLEL_BRANCH_PROCESSING_NAME, nullptr));
+
+    applyParameterSnapshot();
+    eventLogWriter.start();
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {
-    for (auto & parameterID : PluginParameters::getPluginParameterList()) {
-        parameters.removeParameterListener(parameterID, this);
+    parallelBranchProcessing.removeListener(this);
+    branchWorker.stop();
+
+    for (auto & networkIDs : PluginParameters::NETWORK_IDS) {
+        parameters.removeParameterListener(networkIDs.select.getParamID(), this);
     }
     PluginParameters::removeNotAutomatableParameterLayout(parameters.state.getChild(0));
     parameters.state.removeChild(0, nullptr);
@@ -120,52 +115,42 @@ void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String
 
 //==============================================================================
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock) {
+    // hosts may send larger or odd sized blocks than announced, the stages only ever see sub-blocks
+    subBlockSize = juce::jlimit(1, maxSubBlockSize, samplesPerBlock);
+
     juce::dsp::ProcessSpec spec {sampleRate,
-                                 static_cast<juce::uint32>(samplesPerBlock),
+                                 static_cast<juce::uint32>(subBlockSize),
                                  static_cast<juce::uint32>(getTotalNumInputChannels())};
     juce::dsp::ProcessSpec monoSpec {sampleRate,
-                                 static_cast<juce::uint32>(samplesPerBlock),
+                                 static_cast<juce::uint32>(subBlockSize),
                                  static_cast<juce::uint32>(1)};
+    // the host sets the precision before this call, the stages of the other precision give back their memory
+    const auto precision = getProcessingPrecision();
 
-    network1Buffer.setSize((int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
-    network2Buffer.setSize((int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
-    fadeBuffer.setSize((int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
-    grain1DryBuffer.setSize((int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
-    grain2DryBuffer.setSize((int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
-    monoBuffer.setSize((int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
-
-    dryWetMixer.prepare(spec);
-    
-    fadeMixer.prepare(monoSpec);
-    compMixer.prepare(monoSpec);
-    grain1DryWetMixer.prepare(monoSpec);
-    grain2DryWetMixer.prepare(monoSpec);
-    onnxProcessor1.prepare(monoSpec);
-    onnxProcessor2.prepare(monoSpec);
-    iirCutoffFilter1.prepare(monoSpec);
-    iirCutoffFilter2.prepare(monoSpec);
-    processorTransientSplitter1.prepare(monoSpec);
-    processorTransientSplitter2.prepare(monoSpec);
-    processorCompressor.prepare(monoSpec);
+    routingGraphs.prepare(precision, monoSpec);
+    preProcessingLanes.prepare(subBlockSize);
+
+    outputStages.prepare(precision, spec);
+    networkMixer.prepare(monoSpec);
+    for (auto& networkSlot : networkSlots)
+        networkSlot->prepare(monoSpec, samplesPerBlock, precision);
+    processorCompressor.prepare(monoSpec, precision);
     audioVisualiser.prepare(monoSpec);
-    grainDelay1.prepare(monoSpec);
-    grainDelay2.prepare(monoSpec);
-
-    
-    if (onnxProcessor1.getLatency() == onnxProcessor2.getLatency()) {
-        setLatencySamples(onnxProcessor1.getLatency());
-        dryWetMixer.setWetLatency(onnxProcessor1.getLatency());
-//        std::cout << "latency 1: " << onnxProcessor1.getLatency() << std::endl; //DBG
-//        std::cout << "latency 2: " << onnxProcessor2.getLatency() << std::endl; //DBG
-    } else {
-        setLatencySamples(0);
-        dryWetMixer.setWetLatency(0);
-    }
+    stageProfiler.prepare(sampleRate);
+
+    updateLatency();
+
+    if ((bool) parallelBranchProcessing.getValue())
+        branchWorker.start();
 }
 
 void AudioPluginAudioProcessor::releaseResources() {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    // the host calls prepareToPlay again before the next block, which reloads the sessions and reallocates
+    branchWorker.stop();
+
+    for (auto& networkSlot : networkSlots)
+        networkSlot->release();
+    outputStages.forEach([] (auto& outputStage) { outputStage.release(); });
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const {
@@ -194,72 +179,174 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 
 void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& ) {
-    dryWetMixer.setDrySamples(buffer);
-    stereoToMono(monoBuffer, buffer);
-    
-    processorGain.processInputBlock(monoBuffer);
+    processBlockInternal(buffer);
+}
 
-    network1Buffer.makeCopyOf(monoBuffer);
-    network2Buffer.makeCopyOf(monoBuffer);
+void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer,
+                                              juce::MidiBuffer& ) {
+    processBlockInternal(buffer);
+}
 
-    processorTransientSplitter1.processBlock(network1Buffer);
-    processorTransientSplitter2.processBlock(network2Buffer);
+bool AudioPluginAudioProcessor::supportsDoublePrecisionProcessing() const {
+    return true;
+}
 
-    iirCutoffFilter1.processFilters(network1Buffer);
-    iirCutoffFilter2.processFilters(network2Buffer);
+template <typename SampleType>
+void AudioPluginAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType> &buffer) {
+    juce::ScopedNoDenormals noDenormals;
+    SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::callback);
+    stageProfiler.addProcessedSamples(buffer.getNumSamples());
 
-    audioVisualiser.processSample(network1Buffer, network2Buffer);
+    applyParameterSnapshot();
 
-    onnxProcessor1.processBlock(network1Buffer);
-    onnxProcessor2.processBlock(network2Buffer);
+    logRepairs(inputSanitizer.process(buffer), "input");
 
-    levelAnalyser1.processBlock(network1Buffer);
-    levelAnalyser2.processBlock(network2Buffer);
+    // every sub-block hands the branches over once, so whether that pays off is decided for the whole host block
+    const int numSamples = buffer.getNumSamples();
+    const bool forkBranches = branchWorker.isAvailable() && numSamples >= minParallelBlockSize;
 
-    grain1DryBuffer.makeCopyOf(network1Buffer);
-    grain1DryWetMixer.setDrySamples(grain1DryBuffer);
-    grainDelay1.processBlock(network1Buffer);
-    grain1DryWetMixer.setWetSamples(network1Buffer);
+    // the sub-block view refers to the host buffer, within the preallocated channel space this never allocates
+    auto& hostSubBlock = hostSubBlocks.get<SampleType>();
+    for (int offset = 0; offset < numSamples; offset += subBlockSize) {
+        hostSubBlock.setDataToReferTo(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), offset,
+                                      juce::jmin(subBlockSize, numSamples - offset));
+        processSubBlock(hostSubBlock, forkBranches);
+    }
+}
 
-    grain2DryBuffer.makeCopyOf(network2Buffer);
-    grain2DryWetMixer.setDrySamples(grain2DryBuffer);
-    grainDelay2.processBlock(network2Buffer);
-    grain2DryWetMixer.setWetSamples(network2Buffer);
+template <typename SampleType>
+void AudioPluginAudioProcessor::processSubBlock(juce::AudioBuffer<SampleType> &buffer, bool forkBranches) {
+    auto& routingGraph = routingGraphs.get<SampleType>();
+    auto& outputStage = outputStages.get<SampleType>();
+
+    routingGraph.beginBlock(buffer.getNumSamples());
+    auto& mainBus = routingGraph.getMainBus();
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::inputStage);
+        outputStage.pushDrySamples(buffer);
+        stereoToMono(mainBus, buffer);
+        processorGain.processInputBlock(mainBus);
+    }
 
-    if (parameters.getRawParameterValue(PluginParameters::ON_OFF_NETWORK1_ID.getParamID())->load() == 0.f)
-        network1Buffer.clear();
-    if (parameters.getRawParameterValue(PluginParameters::ON_OFF_NETWORK2_ID.getParamID())->load() == 0.f)
-        network2Buffer.clear();
+    const auto& networkBuses = routingGraph.getNetworkBuses();
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::preProcessing);
+        PreProcessingLanes::Networks<SampleType> lanes;
+        for (size_t i = 0; i < networkSlots.size(); ++i)
+            lanes[i] = networkSlots[i]->getPreProcessingLane<SampleType>();
+        preProcessingLanes.process(lanes, mainBus, networkBuses);
+    }
 
-    monoBuffer.makeCopyOf(network1Buffer);
-    fadeMixer.setDrySamples(network2Buffer);
-    fadeMixer.setWetSamples(monoBuffer);
+    int numProcessingBranches = 0;
+    for (auto& networkSlot : networkSlots)
+        numProcessingBranches += networkSlot->isProcessing() ? 1 : 0;
 
-    compMixer.setDrySamples(monoBuffer);
-    processorCompressor.processBlock(monoBuffer);
-    compMixer.setWetSamples(monoBuffer);
+    // the branches are independent until the network mixer, so all but the first can run on the branch worker
+    if (forkBranches && numProcessingBranches > 1) {
+        branchWorker.fork(&AudioPluginAudioProcessor::processForkedBranches<SampleType>, this);
+        processBranch<SampleType>(0);
+        branchWorker.join();
+    } else {
+        for (size_t i = 0; i < networkSlots.size(); ++i)
+            processBranch<SampleType>(i);
+    }
+
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::networkMixer);
+        networkMixer.process(networkBuses, mainBus);
+    }
+
+    // the compressor mix, output gain, mono to stereo and the global dry/wet are one pass in the output stage
+    const SampleType* compressorDry = mainBus.getReadPointer(0);
+    const bool needsCompressorDry = outputStage.needsCompressorDry();
+    if (needsCompressorDry)
+        compressorDry = routingGraph.acquireTap(RoutingGraph<SampleType>::compressorDry, mainBus).getChannelPointer(0);
+
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::compressor);
+        processorCompressor.processBlock(mainBus);
+    }
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::outputStage);
+        logRepairs(outputSanitizer.process(mainBus), "output");
+        outputStage.process(compressorDry, mainBus.getReadPointer(0), buffer);
+    }
 
-    processorGain.processOutputBlock(monoBuffer);
-    monoToStereo(buffer, monoBuffer);
-    dryWetMixer.setWetSamples(buffer);
+    if (needsCompressorDry)
+        routingGraph.releaseTap(RoutingGraph<SampleType>::compressorDry);
+    routingGraph.endBlock();
 }
 
-juce::AudioVisualiserComponent &AudioPluginAudioProcessor::getAudioVisualiser1() {
-    return audioVisualiser.getAudioVisualiser(1);
+template <typename SampleType>
+void AudioPluginAudioProcessor::processBranch(size_t branch) {
+    auto& routingGraph = routingGraphs.get<SampleType>();
+    auto& bus = *routingGraph.getNetworkBuses()[branch];
+
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::visualiser);
+        audioVisualiser.pushSamples((int) branch + 1, bus);
+    }
+    networkSlots[branch]->processNetwork(bus, routingGraph);
+}
+
+template <typename SampleType>
+void AudioPluginAudioProcessor::processForkedBranches(void *processor) {
+    auto& self = *static_cast<AudioPluginAudioProcessor*>(processor);
+    for (size_t i = 1; i < self.networkSlots.size(); ++i)
+        self.processBranch<SampleType>(i);
+}
+
+void AudioPluginAudioProcessor::logRepairs(const SanitizerReport &report, const char *where) {
+    // denormals are flushed all the time and not worth an event, a non-finite sample means something broke;
+    // it usually keeps breaking for a while, so only the first block of a run is logged
+    if (report.startsNonFiniteEpisode)
+        eventLog.log(DiagnosticEvent::Type::samplesRepaired, 0, report.nonFiniteSamples, report.denormalSamples, where);
+}
+
+AudioVisualiser &AudioPluginAudioProcessor::getAudioVisualiser() {
+    return audioVisualiser;
+}
+
+LevelAnalyser &AudioPluginAudioProcessor::getLevelAnalyser(int index) {
+    jassert (index >= 1 && index <= PluginParameters::NUM_NETWORKS);
+    return networkSlots[(size_t) juce::jlimit(0, PluginParameters::NUM_NETWORKS - 1, index - 1)]->getLevelAnalyser();
+}
+
+MemoryUsage AudioPluginAudioProcessor::getMemoryUsage() const {
+    MemoryUsage usage("Scyclone");
+
+    for (const auto& networkSlot : networkSlots)
+        networkSlot->addMemoryUsage(usage.addChild("network " + juce::String(networkSlot->getNumber())));
+
+    usage.add("routing graph", routingGraphs.getSizeInBytes());
+    usage.add("pre-processing lanes", preProcessingLanes.getSizeInBytes());
+    usage.add("compressor", processorCompressor.getSizeInBytes());
+    usage.add("output stage", outputStages.getSizeInBytes());
+    usage.add("audio visualiser", audioVisualiser.getSizeInBytes());
+
+    return usage;
 }
-juce::AudioVisualiserComponent &AudioPluginAudioProcessor::getAudioVisualiser2() {
-    return audioVisualiser.getAudioVisualiser(2);
+
+StageProfiler &AudioPluginAudioProcessor::getStageProfiler() {
+    return stageProfiler;
 }
 
-float AudioPluginAudioProcessor::getCurrentLevel(int index) {
-    if (index == 1) return levelAnalyser1.getCurrentLevel();
-    else if (index == 2) return levelAnalyser2.getCurrentLevel();
-    else return (levelAnalyser1.getCurrentLevel() + levelAnalyser2.getCurrentLevel()) / 2.f;
+EventLogWriter &AudioPluginAudioProcessor::getEventLogWriter() {
+    return eventLogWriter;
 }
 
-void AudioPluginAudioProcessor::setLevelType(LevelType newLevelType) {
-    levelAnalyser1.setLevelType(newLevelType);
-    levelAnalyser2.setLevelType(newLevelType);
+SanitizerReport AudioPluginAudioProcessor::getSanitizerTotals() const {
+    SanitizerReport totals;
+    auto addTotals = [&totals] (const Sanitizer& sanitizer) {
+        totals.nonFiniteSamples += sanitizer.getTotalNonFiniteSamples();
+        totals.denormalSamples += sanitizer.getTotalDenormalSamples();
+    };
+
+    addTotals(inputSanitizer);
+    for (auto& networkSlot : networkSlots)
+        addTotals(networkSlot->getModelOutputSanitizer());
+    addTotals(outputSanitizer);
+    return totals;
 }
 
 //==============================================================================
@@ -290,86 +377,71 @@ void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeI
                                                             .getPropertyAsValue(PluginParameters::NETWORK1_NAME_NAME, nullptr));
             network2Name.referTo(parameters.state.getChildWithName("Settings")
                                                             .getPropertyAsValue(PluginParameters::NETWORK2_NAME_NAME, nullptr));
+            parallelBranchProcessing.referTo(parameters.state.getChildWithName("Settings")
+                                                            .getPropertyAsValue(PluginParameters::PARALLEL_BRANCH_PROCESSING_NAME, nullptr));
         }
 }
 
 void AudioPluginAudioProcessor::parameterChanged(const juce::String &parameterID, float newValue) {
-    processorCompressor.parameterChanged(parameterID, newValue);
-    onnxProcessor1.parameterChanged(parameterID, newValue);
-    onnxProcessor2.parameterChanged(parameterID, newValue);
-    grainDelay1.parameterChanged(parameterID, newValue);
-    grainDelay2.parameterChanged(parameterID, newValue);
-    processorGain.parameterChanged(parameterID, newValue);
-    iirCutoffFilter1.parameterChanged(parameterID, newValue);
-    iirCutoffFilter2.parameterChanged(parameterID, newValue);
-    processorTransientSplitter1.parameterChanged(parameterID, newValue);
-    processorTransientSplitter2.parameterChanged(parameterID, newValue);
-
-    if (parameterID == PluginParameters::DRY_WET_ID.getParamID()) {
-        dryWetMixer.parameterChanged(parameterID, newValue);
-    } else if (parameterID == PluginParameters::COMP_DRY_WET_ID.getParamID()) {
-        compMixer.parameterChanged(parameterID, newValue);
-    } else if (parameterID == PluginParameters::FADE_ID.getParamID()) {
-        fadeMixer.parameterChanged(parameterID, newValue);
-    } else if (parameterID == PluginParameters::GRAIN_NETWORK1_MIX_ID.getParamID()){
-        grain1DryWetMixer.setDryWetProportion(newValue);
-    } else if (parameterID == PluginParameters::GRAIN_NETWORK2_MIX_ID.getParamID()){
-        grain2DryWetMixer.setDryWetProportion(newValue);
+    // only the model selection is listened to, everything else is read from the snapshot in processBlock
+    for (auto& networkSlot : networkSlots)
+        networkSlot->parameterChanged(parameterID, newValue);
+}
+
+void AudioPluginAudioProcessor::valueChanged(juce::Value &value) {
+    if (value.refersToSameSourceAs(parallelBranchProcessing)) {
+        if ((bool) parallelBranchProcessing.getValue())
+            branchWorker.start();
+        else
+            branchWorker.stop();
     }
 }
 
-void AudioPluginAudioProcessor::setInitialMuteParameters() {
-    auto onOffGrain1 = parameters.getRawParameterValue(PluginParameters::GRAIN_ON_OFF_NETWORK1_ID.getParamID())->load();
-    auto onOffGrain2 = parameters.getRawParameterValue(PluginParameters::GRAIN_ON_OFF_NETWORK2_ID.getParamID())->load();
+void AudioPluginAudioProcessor::updateLatency() {
+    // every branch is delayed to the slowest one, switched-off branches included, so toggling a network keeps the
+    // reported latency stable
+    int latency = 0;
+    for (auto& networkSlot : networkSlots)
+        latency = juce::jmax(latency, networkSlot->getLatency());
+
+    for (auto& networkSlot : networkSlots)
+        networkSlot->setLatencyCompensation(latency - networkSlot->getLatency());
 
-    auto onOffNetwork1 = parameters.getRawParameterValue(PluginParameters::ON_OFF_NETWORK1_ID.getParamID())->load();
-    auto onOffNetwork2 = parameters.getRawParameterValue(PluginParameters::ON_OFF_NETWORK1_ID.getParamID())->load();
+    outputStages.forEach([latency] (auto& outputStage) { outputStage.setWetLatency(latency); });
+    if (getLatencySamples() != latency)
+        setLatencySamples(latency);
+}
 
+void AudioPluginAudioProcessor::applyParameterSnapshot() {
+    SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::parameters);
+    parameterSnapshotSource.capture(parameterSnapshot);
 
-    parameterChanged(PluginParameters::ON_OFF_NETWORK1_ID.getParamID(), onOffNetwork1);
-    parameterChanged(PluginParameters::ON_OFF_NETWORK2_ID.getParamID(), onOffNetwork2);
+    processorGain.setParameters(parameterSnapshot);
+    processorCompressor.setParameters(parameterSnapshot);
+    for (size_t i = 0; i < networkSlots.size(); ++i)
+        networkSlots[i]->setParameters(parameterSnapshot.networks[i]);
 
-    parameterChanged(PluginParameters::GRAIN_ON_OFF_NETWORK1_ID.getParamID(), onOffGrain1);
-    parameterChanged(PluginParameters::GRAIN_ON_OFF_NETWORK2_ID.getParamID(), onOffGrain2);
+    outputStages.forEach([this] (auto& outputStage) { outputStage.setParameters(parameterSnapshot); });
+    networkMixer.setFade(parameterSnapshot.fade);
 }
 
-void AudioPluginAudioProcessor::initialiseRnbo(){
-    grainDelay1.setParameterValue(parameters.getRawParameterValue(PluginParameters::GRAIN_NETWORK1_PITCH_ID.getParamID()), 2);
-    grainDelay1.setParameterValue(parameters.getRawParameterValue(PluginParameters::GRAIN_NETWORK1_INTERVAL_ID.getParamID()), 3);
-    grainDelay1.setParameterValue(parameters.getRawParameterValue(PluginParameters::GRAIN_NETWORK1_SIZE_ID.getParamID()), 1);
-    grainDelay2.setParameterValue(parameters.getRawParameterValue(PluginParameters::GRAIN_NETWORK2_PITCH_ID.getParamID()), 2);
-    grainDelay2.setParameterValue(parameters.getRawParameterValue(PluginParameters::GRAIN_NETWORK2_INTERVAL_ID.getParamID()), 3);
-    grainDelay2.setParameterValue(parameters.getRawParameterValue(PluginParameters::GRAIN_NETWORK2_SIZE_ID.getParamID()), 1);
+RaveModel AudioPluginAudioProcessor::getDefaultModel(int networkNumber) {
+    return (networkNumber % 2 == 1) ? FunkDrum : Djembe;
 }
 
-void AudioPluginAudioProcessor::stereoToMono(juce::AudioBuffer<float> &targetMonoBlock, juce::AudioBuffer<float> &sourceBlock) {
+template <typename SampleType>
+void AudioPluginAudioProcessor::stereoToMono(juce::AudioBuffer<SampleType> &targetMonoBlock, const juce::AudioBuffer<SampleType> &sourceBlock) {
+    auto nSamples = sourceBlock.getNumSamples();
+    auto monoWrite = targetMonoBlock.getWritePointer(0);
+
     if (sourceBlock.getNumChannels() == 1) {
-        targetMonoBlock.makeCopyOf(sourceBlock);
+        juce::FloatVectorOperations::copy(monoWrite, sourceBlock.getReadPointer(0), nSamples);
     } else {
-        auto nSamples = sourceBlock.getNumSamples();
-
-        auto monoWrite = targetMonoBlock.getWritePointer(0);
         auto lRead = sourceBlock.getReadPointer(0);
         auto rRead = sourceBlock.getReadPointer(1);
 
-        juce::FloatVectorOperations::copy(monoWrite, lRead, nSamples);
-        juce::FloatVectorOperations::add(monoWrite, rRead, nSamples);
-        juce::FloatVectorOperations::multiply(monoWrite, 0.5f, nSamples);
-    }
-}
-
-void AudioPluginAudioProcessor::monoToStereo(juce::AudioBuffer<float> &targetStereoBlock, juce::AudioBuffer<float> &sourceBlock) {
-    if (sourceBlock.getNumChannels() == 2) {
-        targetStereoBlock.makeCopyOf(sourceBlock);
-    } else {
-        auto nSamples = sourceBlock.getNumSamples();
-
-        auto lWrite = targetStereoBlock.getWritePointer(0);
-        auto rWrite = targetStereoBlock.getWritePointer(1);
-        auto monoRead = sourceBlock.getReadPointer(0);
-
-        juce::FloatVectorOperations::copy(lWrite, monoRead, nSamples);
-        juce::FloatVectorOperations::copy(rWrite, monoRead, nSamples);
+        juce::FloatVectorOperations::add(monoWrite, lRead, rRead, nSamples);
+        juce::FloatVectorOperations::multiply(monoWrite, (SampleType) 0.5, nSamples);
     }
 }
 
@@ -2,19 +2,24 @@
 
 #include <JuceHeader.h>
 #include "PluginParameters.h"
+#include "ParameterSnapshot.h"
 #include "dsp/compressor/ProcessorCompressor.h"
-#include "dsp/transientSplitter/ProcessorTransientSplitter.h"
-#include "dsp/mixer/DryWetMixer.h"
+#include "dsp/mixer/NetworkMixer.h"
+#include "dsp/mixer/OutputStage.h"
 #include "dsp/analyser/AudioVisualiser.h"
-#include "dsp/analyser/LevelAnalyser.h"
-#include "dsp/onnx/OnnxProcessor.h"
 #include "dsp/gain/ProcessorGain.h"
-#include "dsp/Filter/IIRCutoffFilter.h"
-#include "dsp/grainDelay/GrainDelay.h"
+#include "dsp/networkSlot/NetworkSlot.h"
+#include "dsp/routing/RoutingGraph.h"
+#include "dsp/routing/BranchWorker.h"
+#include "dsp/utils/Sanitizer.h"
+#include "dsp/utils/MemoryUsage.h"
+#include "dsp/utils/EventLog.h"
+#include "dsp/utils/StageProfiler.h"
+#include "dsp/utils/PerPrecision.h"
 
 
 //==============================================================================
-    class AudioPluginAudioProcessor  : public juce::AudioProcessor, private juce::AudioProcessorValueTreeState::Listener
+    class AudioPluginAudioProcessor  : public juce::AudioProcessor, private juce::AudioProcessorValueTreeState::Listener, private juce::Value::Listener
 {
 public:
     //==============================================================================
@@ -28,7 +33,8 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-    using AudioProcessor::processBlock;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,66 +62,85 @@ public:
     juce::Value advancedParameterControlVisible;
     juce::Value network1Name;
     juce::Value network2Name;
+    juce::Value parallelBranchProcessing;
 
     std::function<void(juce::String newName)>onNetwork1NameChange;
     std::function<void(juce::String newName)>onNetwork2NameChange;
 public:
-    juce::AudioVisualiserComponent& getAudioVisualiser1();
-    juce::AudioVisualiserComponent& getAudioVisualiser2();
-    float getCurrentLevel(int index);
-    void setLevelType(LevelType newLevelType);
+    AudioVisualiser& getAudioVisualiser();
+    // index 1 or 2, the history may only be read from one thread
+    LevelAnalyser& getLevelAnalyser(int index);
+
+    SanitizerReport getSanitizerTotals() const;
+    // what this instance holds right now, call from the message thread
+    MemoryUsage getMemoryUsage() const;
+    EventLogWriter& getEventLogWriter();
+    // collect from one thread only
+    StageProfiler& getStageProfiler();
 
     std::function<void(int modelID, juce::String& modelName)> setExternalModelName;
-    void setInitialMuteParameters();
-    void initialiseRnbo();
     void loadExternalModel(juce::File path, int id) {
-        if (id == 1) onnxProcessor1.loadExternalModel(path);
-        if (id == 2) onnxProcessor2.loadExternalModel(path);
+        if (id >= 1 && id <= PluginParameters::NUM_NETWORKS)
+            networkSlots[(size_t) (id - 1)]->loadExternalModel(path);
     }
 
 private:
     void parameterChanged (const juce::String& parameterID, float newValue) override;
-    static void stereoToMono(juce::AudioBuffer<float>& targetMonoBlock, juce::AudioBuffer<float>& sourceBlock);
-    static void monoToStereo(juce::AudioBuffer<float>& targetStereoBlock, juce::AudioBuffer<float>& sourceBlock);
+    void applyParameterSnapshot();
+    void valueChanged (juce::Value& value) override;
+    void updateLatency();
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    void processSubBlock(juce::AudioBuffer<SampleType>& buffer, bool forkBranches);
+    template <typename SampleType>
+    void processBranch(size_t branch);
+    template <typename SampleType>
+    static void processForkedBranches(void* processor);
+    void logRepairs(const SanitizerReport& report, const char* where);
+    template <typename SampleType>
+    static void stereoToMono(juce::AudioBuffer<SampleType>& targetMonoBlock, const juce::AudioBuffer<SampleType>& sourceBlock);
 
 private:
     juce::AudioProcessorValueTreeState parameters;
+    ParameterSnapshotSource parameterSnapshotSource;
+    ParameterSnapshot parameterSnapshot;
 
-    ProcessorGain inputGain;
-    ProcessorGain outputGain;
-
-    ProcessorTransientSplitter processorTransientSplitter1;
-    ProcessorTransientSplitter processorTransientSplitter2;
-    
-    IIRCutoffFilter iirCutoffFilter1;
-    IIRCutoffFilter iirCutoffFilter2;
+    // declared before everything that logs into it
+    EventLog eventLog;
+    EventLogWriter eventLogWriter {eventLog};
+    StageProfiler stageProfiler;
 
-    juce::AudioBuffer<float> fadeBuffer;
-    juce::AudioBuffer<float> network1Buffer;
-    juce::AudioBuffer<float> network2Buffer;
-    juce::AudioBuffer<float> grain1DryBuffer;
-    juce::AudioBuffer<float> grain2DryBuffer;
-    juce::AudioBuffer<float> monoBuffer;
+    static RaveModel getDefaultModel(int networkNumber);
 
+    ProcessorGain inputGain;
+    ProcessorGain outputGain;
 
-    DryWetMixer dryWetMixer;
-    DryWetMixer fadeMixer;
-    DryWetMixer compMixer;
-    DryWetMixer grain1DryWetMixer;
-    DryWetMixer grain2DryWetMixer;
+    std::array<std::unique_ptr<NetworkSlot>, PluginParameters::NUM_NETWORKS> networkSlots;
+    PerPrecision<RoutingGraph> routingGraphs;
+    PreProcessingLanes preProcessingLanes;
+    BranchWorker branchWorker;
 
-    OnnxProcessor onnxProcessor1;
-    OnnxProcessor onnxProcessor2;
+    NetworkMixer networkMixer;
+    PerPrecision<OutputStage> outputStages;
 
     ProcessorCompressor processorCompressor;
     
     AudioVisualiser audioVisualiser;
-    LevelAnalyser levelAnalyser1;
-    LevelAnalyser levelAnalyser2;
     ProcessorGain processorGain;
 
-    GrainDelay grainDelay1;
-    GrainDelay grainDelay2;
+    Sanitizer inputSanitizer;
+    Sanitizer outputSanitizer;
+
+    // the host block is processed in sub-blocks of at most this size, every stage is prepared for it
+    int subBlockSize = maxSubBlockSize;
+    PerPrecision<juce::AudioBuffer> hostSubBlocks;
+    static constexpr int maxSubBlockSize = 128;
+
+    // Host block size from which the branches are forked. The worker is handed every sub-block, but it keeps spinning
+    // between them, so only the first hand-over of a host block can wake a parked worker. A host block of a single
+    // sub-block pays that wake-up for one sub-block of work, which costs more than it saves.
+    static constexpr int minParallelBlockSize = 2 * maxSubBlockSize;
 
     //==============================================================================
     JUCE_HEAVYWEIGHT_LEAK_DETECTOR (AudioPluginAudioProcessor)
@@ -3,123 +3,223 @@
 //
 
 #include "IIRCutoffFilter.h"
+#include "../utils/MemoryUsage.h"
 
-IIRCutoffFilter::IIRCutoffFilter(const juce::AudioProcessorValueTreeState &apvts, int no) : index(no),   lowPassFilter(juce::dsp::IIR::Coefficients<float>::makeLowPass(48000, 20000.0f, 1.0)),
-                                                   highPassFilter(juce::dsp::IIR::Coefficients<float>::makeHighPass(48000, 20.0f, 1.0))
+template <typename SampleType>
+IIRCutoffFilter<SampleType>::IIRCutoffFilter(const juce::AudioProcessorValueTreeState &apvts, int no) : index(no)
 {
     targetFreqRangeHPF = {20.0, 8000.0};
     targetFreqRangeLPF = {100.0, 20000.0};
     targetFreqRangeHPF.setSkewForCentre(500.0);
     targetFreqRangeLPF.setSkewForCentre(500.0);
-    if (index == 1) updateFilterParams(apvts.getRawParameterValue(PluginParameters::FILTER_NETWORK1_ID.getParamID())->load());
-    if (index == 2) updateFilterParams(apvts.getRawParameterValue(PluginParameters::FILTER_NETWORK2_ID.getParamID())->load());
+    updateFilterParams(apvts.getRawParameterValue(PluginParameters::getNetworkIDs(index).filter.getParamID())->load());
 }
 
-IIRCutoffFilter::~IIRCutoffFilter()
+template <typename SampleType>
+IIRCutoffFilter<SampleType>::~IIRCutoffFilter()
 {
 }
 
-void IIRCutoffFilter::updateLPFilterParams(double freq, double q)
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::prepare(const juce::dsp::ProcessSpec &spec)
 {
-    filterParamsLP.freq = freq;
-    filterParamsLP.q = q;
-    filterParamsLP.enabled = (freq < 20000);
-    *lowPassFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSpec.sampleRate,
-                                                                          (float)freq,
-                                                                          (float)q);
+    currentSpec = spec;
+
+    buildCoefficientTable(lowPassCoefficients, targetFreqRangeLPF);
+    buildCoefficientTable(highPassCoefficients, targetFreqRangeHPF);
+
+    lowPassStates.assign(spec.numChannels, {});
+    highPassStates.assign(spec.numChannels, {});
+
+    const auto yPos = targetPosition.load();
+    position.reset(spec.sampleRate, positionSmoothingInSeconds);
+    position.setCurrentAndTargetValue(yPos);
+    lowPassAmount.reset(spec.sampleRate, crossfadeInSeconds);
+    lowPassAmount.setCurrentAndTargetValue(yPos < 0.5f ? 1.f : 0.f);
+    highPassAmount.reset(spec.sampleRate, crossfadeInSeconds);
+    highPassAmount.setCurrentAndTargetValue(yPos > 0.5f ? 1.f : 0.f);
 }
 
-void IIRCutoffFilter::updateHPFilterParams(double freq, double q)
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::updateFilterParams(const float yPos)
 {
-    filterParamsHP.freq = freq;
-    filterParamsHP.q = q;
-    filterParamsHP.enabled = (freq > 20);
-    *highPassFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(currentSpec.sampleRate,
-                                                                            (float)freq,
-                                                                            (float)q);
+    targetPosition.store(std::clamp(yPos, 0.f, 1.f));
 }
 
-void IIRCutoffFilter::prepare(const juce::dsp::ProcessSpec &spec)
-{
-    currentSpec = spec;
-    
-    lowPassFilter.reset();
-    lowPassFilter.prepare(spec);
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::processFilters(juce::AudioBuffer<SampleType> &buffer) {
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int) lowPassStates.size());
+    auto channels = buffer.getArrayOfWritePointers();
+
+    beginBlock();
+
+    SVFCoefficients low, high;
+    float lowPassMix, highPassMix;
+
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
+        nextCoefficients(low, high, lowPassMix, highPassMix);
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            const auto input = channels[channel][sample];
 
-    highPassFilter.reset();
-    highPassFilter.prepare(spec);
+            auto& hp = highPassStates[(size_t) channel];
+            const auto v3High = input - hp.ic2eq;
+            const auto v1High = high.a1 * hp.ic1eq + high.a2 * v3High;
+            const auto v2High = hp.ic2eq + high.a2 * hp.ic1eq + high.a3 * v3High;
+            hp.ic1eq = 2 * v1High - hp.ic1eq;
+            hp.ic2eq = 2 * v2High - hp.ic2eq;
+            const auto highPassed = input - damping * v1High - v2High;
+            const auto afterHighPass = input + (SampleType) highPassMix * (highPassed - input);
+
+            auto& lp = lowPassStates[(size_t) channel];
+            const auto v3Low = afterHighPass - lp.ic2eq;
+            const auto v1Low = low.a1 * lp.ic1eq + low.a2 * v3Low;
+            const auto v2Low = lp.ic2eq + low.a2 * lp.ic1eq + low.a3 * v3Low;
+            lp.ic1eq = 2 * v1Low - lp.ic1eq;
+            lp.ic2eq = 2 * v2Low - lp.ic2eq;
+
+            channels[channel][sample] = afterHighPass + (SampleType) lowPassMix * (v2Low - afterHighPass);
+        }
+    }
 }
 
-void IIRCutoffFilter::updateFilterParams(const float yPos)
-{
-    juce::NormalisableRange<float> sourceRange;
-    if (yPos >= 0.5f) // highpass
-    {
-        const auto clampedYPos = std::clamp(yPos, 0.5f, 1.f);
-        sourceRange =  {0.5, 1.0};
-        filterParamsHP.enabled = true;
-        filterParamsLP.enabled = false;
-        const auto normalizedValue = sourceRange.convertTo0to1(clampedYPos);
-//        std::cout << "normalized Value HPF: " << normalizedValue << std::endl; //DBG
-        const auto targetFreq =  targetFreqRangeHPF.convertFrom0to1(normalizedValue);
-        updateHPFilterParams(targetFreq, filterParamsHP.q);
+template <>
+void IIRCutoffFilter<float>::processLanes(IIRCutoffFilter<float>* const* filters, int numLanes, LaneBuffer &buffer) {
+    constexpr int lanes = LaneBuffer::maxLanes;
+    jassert (numLanes <= lanes);
+
+    // coefficients and first-channel state of every lane, unused lanes run with zeros
+    alignas(16) float a1Low[lanes] {}, a2Low[lanes] {}, a3Low[lanes] {}, lowMix[lanes] {};
+    alignas(16) float a1High[lanes] {}, a2High[lanes] {}, a3High[lanes] {}, highMix[lanes] {};
+    alignas(16) float lowIc1[lanes] {}, lowIc2[lanes] {}, highIc1[lanes] {}, highIc2[lanes] {};
+    bool smoothing[lanes] {};
+
+    auto updateLane = [&] (int lane) {
+        SVFCoefficients low, high;
+        filters[lane]->nextCoefficients(low, high, lowMix[lane], highMix[lane]);
+        a1Low[lane] = low.a1; a2Low[lane] = low.a2; a3Low[lane] = low.a3;
+        a1High[lane] = high.a1; a2High[lane] = high.a2; a3High[lane] = high.a3;
+    };
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        auto& filter = *filters[lane];
+        filter.beginBlock();
+        smoothing[lane] = filter.isSmoothing();
+        // settled lanes keep the coefficients of the first sample for the whole block
+        if (!smoothing[lane])
+            updateLane(lane);
+
+        lowIc1[lane] = filter.lowPassStates[0].ic1eq;
+        lowIc2[lane] = filter.lowPassStates[0].ic2eq;
+        highIc1[lane] = filter.highPassStates[0].ic1eq;
+        highIc2[lane] = filter.highPassStates[0].ic2eq;
     }
-    else if (yPos < 0.5f) // lowpass
-    {
-        const auto clampedYPos = std::clamp(yPos, 0.0f, 0.5f);
-        sourceRange = {0.0, 0.5};
-        filterParamsLP.enabled = true;
-        filterParamsHP.enabled = false;
-        const auto normalizedValue = sourceRange.convertTo0to1(clampedYPos);
-//        std::cout << "normalized Value LPF: " << normalizedValue << std::endl; //DBG
-        const auto targetFreq =  targetFreqRangeLPF.convertFrom0to1(normalizedValue);
-        updateLPFilterParams(targetFreq, filterParamsLP.q);
+
+    auto frames = buffer.getFrames();
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
+        for (int lane = 0; lane < numLanes; ++lane)
+            if (smoothing[lane])
+                updateLane(lane);
+
+        auto& frame = frames[sample].lanes;
+        for (int lane = 0; lane < lanes; ++lane) {
+            const float input = frame[lane];
+
+            const float v3High = input - highIc2[lane];
+            const float v1High = a1High[lane] * highIc1[lane] + a2High[lane] * v3High;
+            const float v2High = highIc2[lane] + a2High[lane] * highIc1[lane] + a3High[lane] * v3High;
+            highIc1[lane] = 2.f * v1High - highIc1[lane];
+            highIc2[lane] = 2.f * v2High - highIc2[lane];
+            const float highPassed = input - damping * v1High - v2High;
+            const float afterHighPass = input + highMix[lane] * (highPassed - input);
+
+            const float v3Low = afterHighPass - lowIc2[lane];
+            const float v1Low = a1Low[lane] * lowIc1[lane] + a2Low[lane] * v3Low;
+            const float v2Low = lowIc2[lane] + a2Low[lane] * lowIc1[lane] + a3Low[lane] * v3Low;
+            lowIc1[lane] = 2.f * v1Low - lowIc1[lane];
+            lowIc2[lane] = 2.f * v2Low - lowIc2[lane];
+
+            frame[lane] = afterHighPass + lowMix[lane] * (v2Low - afterHighPass);
+        }
+    }
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        auto& filter = *filters[lane];
+        filter.lowPassStates[0] = {lowIc1[lane], lowIc2[lane]};
+        filter.highPassStates[0] = {highIc1[lane], highIc2[lane]};
     }
 }
 
-void IIRCutoffFilter::processHPFilter(juce::AudioBuffer<float>& buffer) {
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::beginBlock() {
+    position.setTargetValue(targetPosition.load());
+    // the side that is not selected fades out, at 0.5 both filters are bypassed
+    const auto currentPosition = position.getCurrentValue();
+    lowPassAmount.setTargetValue(currentPosition < 0.5f ? 1.f : 0.f);
+    highPassAmount.setTargetValue(currentPosition > 0.5f ? 1.f : 0.f);
+}
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
-    if (filterParamsHP.enabled)
-        highPassFilter.process(context);
-    else
-        return;
+template <typename SampleType>
+bool IIRCutoffFilter<SampleType>::isSmoothing() const {
+    return position.isSmoothing() || lowPassAmount.isSmoothing() || highPassAmount.isSmoothing();
 }
 
-void IIRCutoffFilter::processLPFilter(juce::AudioBuffer<float>& buffer) {
-     juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
-    if (filterParamsLP.enabled)
-        lowPassFilter.process(context);
-    else return;
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::nextCoefficients(SVFCoefficients &lowPass, SVFCoefficients &highPass, float &lowPassMix, float &highPassMix) {
+    const auto yPos = position.getNextValue();
+    lowPassMix = lowPassAmount.getNextValue();
+    highPassMix = highPassAmount.getNextValue();
+
+    lowPass = makeCoefficients(lookupCoefficient(lowPassCoefficients, std::clamp(2.f * yPos, 0.f, 1.f)));
+    highPass = makeCoefficients(lookupCoefficient(highPassCoefficients, std::clamp(2.f * yPos - 1.f, 0.f, 1.f)));
 }
 
-void IIRCutoffFilter::processFilters(juce::AudioBuffer<float> &buffer) {
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-                float sampleToCheck = buffer.getSample(channel, sample);
-                if (isnan(sampleToCheck)) {
-                    return;
-                }
-            }
-        }
-    processHPFilter(buffer);
-    processLPFilter(buffer);
+template <typename SampleType>
+typename IIRCutoffFilter<SampleType>::SVFCoefficients IIRCutoffFilter<SampleType>::makeCoefficients(SampleType g) {
+    SVFCoefficients coefficients;
+    coefficients.a1 = 1 / (1 + g * (g + damping));
+    coefficients.a2 = g * coefficients.a1;
+    coefficients.a3 = g * coefficients.a2;
+    return coefficients;
 }
 
-void IIRCutoffFilter::parameterChanged(const juce::String &parameterID, float newValue) {
-    if (parameterID == PluginParameters::FILTER_NETWORK1_ID.getParamID() && index == 1) {
-        updateFilterParams(newValue);
-    } else if (parameterID == PluginParameters::FILTER_NETWORK2_ID.getParamID() && index == 2) {
-        updateFilterParams(newValue);
-    } else if (parameterID == PluginParameters::ON_OFF_NETWORK1_ID.getParamID() && index == 1) {
-        setMuted((bool)!newValue);
-    } else if (parameterID == PluginParameters::ON_OFF_NETWORK2_ID.getParamID() && index == 2) {
-        setMuted((bool)!newValue);
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::buildCoefficientTable(std::vector<SampleType> &table, juce::NormalisableRange<float> frequencyRange) {
+    const auto maxFrequency = 0.49 * currentSpec.sampleRate;
+    table.resize(coefficientTableSize + 1);
+
+    for (int i = 0; i <= coefficientTableSize; ++i) {
+        const auto frequency = juce::jmin((double) frequencyRange.convertFrom0to1((float) i / (float) coefficientTableSize), maxFrequency);
+        table[(size_t) i] = (SampleType) std::tan(juce::MathConstants<double>::pi * frequency / currentSpec.sampleRate);
     }
 }
 
-void IIRCutoffFilter::setMuted(bool shouldBeMuted) {
+template <typename SampleType>
+SampleType IIRCutoffFilter<SampleType>::lookupCoefficient(const std::vector<SampleType> &table, float normalisedPosition) const {
+    const auto tablePosition = normalisedPosition * (float) coefficientTableSize;
+    const auto tableIndex = juce::jmin((int) tablePosition, coefficientTableSize - 1);
+    const auto fraction = (SampleType) (tablePosition - (float) tableIndex);
+    return table[(size_t) tableIndex] + fraction * (table[(size_t) tableIndex + 1] - table[(size_t) tableIndex]);
+}
+
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::release() {
+    lowPassCoefficients = {};
+    highPassCoefficients = {};
+    lowPassStates = {};
+    highPassStates = {};
+}
+
+template <typename SampleType>
+void IIRCutoffFilter<SampleType>::setMuted(bool shouldBeMuted) {
     isMuted = shouldBeMuted;
 }
+
+template <typename SampleType>
+size_t IIRCutoffFilter<SampleType>::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(lowPassCoefficients) + MemoryUsage::getSizeInBytes(highPassCoefficients)
+           + MemoryUsage::getSizeInBytes(lowPassStates) + MemoryUsage::getSizeInBytes(highPassStates);
+}
+
+template class IIRCutoffFilter<float>;
+template class IIRCutoffFilter<double>;
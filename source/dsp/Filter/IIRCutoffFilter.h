@@ -7,44 +7,80 @@
 
 #include <JuceHeader.h>
 #include "../../PluginParameters.h"
+#include "../utils/LaneBuffer.h"
 
+/*  Cutoff filter controlled by one position: below 0.5 a low pass, above 0.5 a high pass, 0.5 is transparent.
+ *  Both sides are topology-preserving state variable filters whose cutoff follows the smoothed position sample by
+ *  sample. The position-to-coefficient mapping is tabulated in prepare, and the switch between the low and the high
+ *  pass is crossfaded. Parameter updates only store an atomic, so they never allocate and are safe from any thread.
+ */
+template <typename SampleType>
 class IIRCutoffFilter
 {
 public:
     IIRCutoffFilter(const juce::AudioProcessorValueTreeState &apvts, int no);
     ~IIRCutoffFilter();
-    void updateLPFilterParams(double freq, double q);
-    void updateHPFilterParams(double freq, double q);
 
     void prepare(const juce::dsp::ProcessSpec &spec);
+    void release();
+    void processFilters(juce::AudioBuffer<SampleType>& buffer);
 
-    void processLPFilter(juce::AudioBuffer<float>& buffer);
-    void processHPFilter(juce::AudioBuffer<float>& buffer);
-    void processFilters(juce::AudioBuffer<float>& buffer);
+    // filters lane i of the buffer with filters[i], all lanes in the same pass; the lanes are float only
+    static void processLanes(IIRCutoffFilter* const* filters, int numLanes, LaneBuffer& buffer);
 
-    void parameterChanged(const juce::String &parameterID, float newValue);
     void updateFilterParams(const float yPos);
 
     void setMuted(bool shouldBeMuted);
+    size_t getSizeInBytes() const;
+
+private:
+    struct SVFState {
+        SampleType ic1eq = 0;
+        SampleType ic2eq = 0;
+    };
+
+    struct SVFCoefficients {
+        SampleType a1 = 1;
+        SampleType a2 = 0;
+        SampleType a3 = 0;
+    };
+
+    void beginBlock();
+    bool isSmoothing() const;
+    void nextCoefficients(SVFCoefficients& lowPass, SVFCoefficients& highPass, float& lowPassMix, float& highPassMix);
+    static SVFCoefficients makeCoefficients(SampleType g);
+
+    void buildCoefficientTable(std::vector<SampleType>& table, juce::NormalisableRange<float> frequencyRange);
+    SampleType lookupCoefficient(const std::vector<SampleType>& table, float normalisedPosition) const;
 
 private:
     int index;
     bool isMuted = false;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> lowPassFilter;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> highPassFilter;
     juce::NormalisableRange<float> targetFreqRangeHPF;
     juce::NormalisableRange<float> targetFreqRangeLPF;
 
+    std::atomic<float> targetPosition {0.5f};
+    juce::SmoothedValue<float> position;
+    juce::SmoothedValue<float> lowPassAmount;
+    juce::SmoothedValue<float> highPassAmount;
 
-    struct FILTER_PARAMS{
-        double freq;
-        double q = 0.5;
-        bool enabled = false;
-    };
+    // tan(pi * f / fs) over the normalised position of each side
+    std::vector<SampleType> lowPassCoefficients;
+    std::vector<SampleType> highPassCoefficients;
+
+    std::vector<SVFState> lowPassStates;
+    std::vector<SVFState> highPassStates;
 
     juce::dsp::ProcessSpec currentSpec = {48000, 512, 1};
-    FILTER_PARAMS filterParamsHP, filterParamsLP;
+
+    static constexpr SampleType damping = 2; // 1 / q with q = 0.5
+    static constexpr int coefficientTableSize = 512;
+    static constexpr double positionSmoothingInSeconds = 0.05;
+    static constexpr double crossfadeInSeconds = 0.02;
 };
 
+template <>
+void IIRCutoffFilter<float>::processLanes(IIRCutoffFilter<float>* const* filters, int numLanes, LaneBuffer& buffer);
+
 
 #endif //VAESYNTH_IIRCUTOFFFILTER_H
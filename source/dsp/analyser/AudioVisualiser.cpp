@@ -4,47 +4,77 @@
 
 #include "AudioVisualiser.h"
 
-AudioVisualiser::AudioVisualiser() : audioVisualiserComponent1(1), audioVisualiserComponent2(1) {
-
-    audioVisualiserComponent1.setRepaintRate(30);
-    audioVisualiserComponent2.setRepaintRate(30);
-    audioVisualiserComponent1.setSamplesPerBlock(256);
-    audioVisualiserComponent2.setSamplesPerBlock(256);
-    audioVisualiserComponent1.setBufferSize(512);
-    audioVisualiserComponent2.setBufferSize(512);
+void AudioVisualiser::prepare(const juce::dsp::ProcessSpec &spec) {
+    sampleRate = spec.sampleRate;
+    for (auto& waveform : waveforms) {
+        waveform.currentRange = {};
+        waveform.samplesInColumn = 0;
+    }
 }
 
-void AudioVisualiser::prepare(const juce::dsp::ProcessSpec &spec) {
-    juce::ignoreUnused(spec);
-}
-
-void AudioVisualiser::processSample(juce::AudioBuffer<float> &buffer1, juce::AudioBuffer<float> &buffer2) {
-    for (int channel = 0; channel < buffer1.getNumChannels(); ++channel) {
-            for (int sample = 0; sample < buffer1.getNumSamples(); ++sample) {
-                float sampleToCheck = buffer1.getSample(channel, sample);
-                if (isnan(sampleToCheck)) {
-                    return;
-                }
-            }
-        }
-
-        for (int channel = 0; channel < buffer2.getNumChannels(); ++channel) {
-            for (int sample = 0; sample < buffer2.getNumSamples(); ++sample) {
-                float sampleToCheck = buffer2.getSample(channel, sample);
-                if (isnan(sampleToCheck)) {
-                    return;
-                }
-            }
-        }
-
-        audioVisualiserComponent1.pushBuffer(buffer1.getArrayOfReadPointers(), 1, buffer1.getNumSamples());
-        audioVisualiserComponent2.pushBuffer(buffer2.getArrayOfReadPointers(), 1, buffer2.getNumSamples());
-}
-
-juce::AudioVisualiserComponent &AudioVisualiser::getAudioVisualiser(int id) {
-    if (id == 1) {
-        return audioVisualiserComponent1;
-    } else {
-        return audioVisualiserComponent2;
+template <typename SampleType>
+void AudioVisualiser::pushSamples(int id, const juce::AudioBuffer<SampleType> &buffer) {
+    auto& waveform = getWaveform(id);
+    const int samplesPerColumn = getSamplesPerColumn(waveform);
+    const int numSamples = buffer.getNumSamples();
+    auto data = buffer.getReadPointer(0);
+
+    for (int sample = 0; sample < numSamples;) {
+        const int numToScan = juce::jmin(numSamples - sample, samplesPerColumn - waveform.samplesInColumn);
+        const auto scanned = juce::FloatVectorOperations::findMinAndMax(data + sample, numToScan);
+        const juce::Range<float> range ((float) scanned.getStart(), (float) scanned.getEnd());
+
+        waveform.currentRange = waveform.samplesInColumn == 0 ? range : waveform.currentRange.getUnionWith(range);
+        waveform.samplesInColumn += numToScan;
+        sample += numToScan;
+
+        if (waveform.samplesInColumn >= samplesPerColumn)
+            finishColumn(waveform);
     }
 }
+
+void AudioVisualiser::setNumColumns(int id, int numColumns) {
+    getWaveform(id).numColumns.store(juce::jmax(1, numColumns));
+}
+
+int AudioVisualiser::readColumns(int id, WaveformColumn *destination, int maxColumns) {
+    auto& waveform = getWaveform(id);
+
+    // A full ring holds the columns from before it filled up and misses everything since, so all of it is stale.
+    // Otherwise only the newest display width is worth drawing, anything older would scroll out right away.
+    const bool stale = waveform.overflowed.exchange(false);
+    const int numReady = waveform.fifo.getNumReady();
+    const int numToRead = stale ? 0 : juce::jmin(numReady, maxColumns, waveform.numColumns.load());
+    waveform.fifo.finishedRead(numReady - numToRead);
+
+    const auto scope = waveform.fifo.read(numToRead);
+    std::copy_n(waveform.columns.begin() + scope.startIndex1, scope.blockSize1, destination);
+    std::copy_n(waveform.columns.begin() + scope.startIndex2, scope.blockSize2, destination + scope.blockSize1);
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+AudioVisualiser::Waveform &AudioVisualiser::getWaveform(int id) {
+    return waveforms[(size_t) juce::jlimit(0, PluginParameters::NUM_NETWORKS - 1, id - 1)];
+}
+
+int AudioVisualiser::getSamplesPerColumn(const Waveform &waveform) const {
+    return juce::jmax(1, (int) (displayLengthInSeconds * sampleRate) / waveform.numColumns.load(std::memory_order_relaxed));
+}
+
+void AudioVisualiser::finishColumn(Waveform &waveform) {
+    // a viewer that is closed or behind misses columns, and drops what is left in the ring on its next read
+    const auto scope = waveform.fifo.write(1);
+    if (scope.blockSize1 > 0)
+        waveform.columns[(size_t) scope.startIndex1] = {waveform.currentRange.getStart(), waveform.currentRange.getEnd()};
+    else
+        waveform.overflowed.store(true);
+
+    waveform.samplesInColumn = 0;
+}
+
+size_t AudioVisualiser::getSizeInBytes() const {
+    return sizeof(waveforms);
+}
+
+template void AudioVisualiser::pushSamples<float>(int, const juce::AudioBuffer<float>&);
+template void AudioVisualiser::pushSamples<double>(int, const juce::AudioBuffer<double>&);
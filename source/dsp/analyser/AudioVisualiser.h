@@ -6,19 +6,51 @@
 #define VAESYNTH_AUDIOVISUALISER_H
 
 #include "JuceHeader.h"
+#include "../../PluginParameters.h"
 
+struct WaveformColumn {
+    float minimum = 0.f;
+    float maximum = 0.f;
+};
+
+/*  Decimates every network bus into min/max columns, one per pixel of the viewer, and hands them to the UI through a
+ *  lock-free single-producer single-consumer ring per network. The audio thread only compares and counts; the
+ *  viewer tells it how many columns span the display.
+ */
 class AudioVisualiser {
 public:
-    AudioVisualiser();
-
     void prepare(const juce::dsp::ProcessSpec &spec);
-    void processSample(juce::AudioBuffer<float> &buffer1, juce::AudioBuffer<float> &buffer2);
+    // id is the network number, each network must be pushed from one thread only
+    template <typename SampleType>
+    void pushSamples(int id, const juce::AudioBuffer<SampleType> &buffer);
+
+    // reader side, one thread only; a backlog older than one display width is discarded, not returned
+    void setNumColumns(int id, int numColumns);
+    int readColumns(int id, WaveformColumn* destination, int maxColumns);
 
-    juce::AudioVisualiserComponent& getAudioVisualiser(int id);
+    size_t getSizeInBytes() const;
+
+    static constexpr int ringSize = 2048;
+    // the span of the former AudioVisualiserComponent: 512 blocks of 256 samples at 48 kHz
+    static constexpr double displayLengthInSeconds = 2.73;
 
 private:
-    juce::AudioVisualiserComponent audioVisualiserComponent1;
-    juce::AudioVisualiserComponent audioVisualiserComponent2;
+    struct Waveform {
+        juce::AbstractFifo fifo {ringSize};
+        std::array<WaveformColumn, ringSize> columns;
+        std::atomic<int> numColumns {512};
+        // set by the audio thread when a column found the ring full
+        std::atomic<bool> overflowed {false};
+        juce::Range<float> currentRange;
+        int samplesInColumn = 0;
+    };
+
+    Waveform& getWaveform(int id);
+    int getSamplesPerColumn(const Waveform& waveform) const;
+    static void finishColumn(Waveform& waveform);
+
+    std::array<Waveform, PluginParameters::NUM_NETWORKS> waveforms;
+    double sampleRate = 48000.;
 };
 
 #endif //VAESYNTH_AUDIOVISUALISER_H
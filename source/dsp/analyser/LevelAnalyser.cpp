@@ -4,30 +4,73 @@
 
 #include "LevelAnalyser.h"
 
-void LevelAnalyser::processBlock(juce::AudioBuffer<float> &buffer) {
-    switch (levelType)
-    {
-        case PEAK:
-            currentPeak.store(buffer.getMagnitude(0, buffer.getNumSamples()));
-            break;
-        case RMS:
-            float newRMS = 0;
-            for (int i = 0; i < buffer.getNumChannels(); ++i) {
-                newRMS += buffer.getRMSLevel(i, 0, buffer.getNumSamples()) / ((float) i + 1);
-            }
-            currentRMS.store(newRMS);
-            break;
-    }
+template <typename SampleType>
+void LevelAnalyser::processBlock(const juce::AudioBuffer<SampleType> &buffer) {
+    const auto summary = analyse(buffer);
+
+    // a reader that fell behind loses the newest blocks, the audio thread never waits
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 > 0)
+        history[(size_t) scope.startIndex1] = summary;
+    else
+        droppedSummaries.fetch_add(1, std::memory_order_relaxed);
 }
 
-void LevelAnalyser::setLevelType(LevelType newLevelType) {
-    levelType = newLevelType;
+int LevelAnalyser::readHistory(LevelSummary *destination, int maxSummaries) {
+    const auto scope = fifo.read(juce::jmin(maxSummaries, fifo.getNumReady()));
+    std::copy_n(history.begin() + scope.startIndex1, scope.blockSize1, destination);
+    std::copy_n(history.begin() + scope.startIndex2, scope.blockSize2, destination + scope.blockSize1);
+    return scope.blockSize1 + scope.blockSize2;
 }
 
-float LevelAnalyser::getCurrentLevel() {
-    if (levelType == PEAK) {
-        return currentPeak.load();
-    } else {
-        return currentRMS.load();
+int LevelAnalyser::getNumDroppedSummaries() const {
+    return droppedSummaries.load(std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+LevelSummary LevelAnalyser::analyse(const juce::AudioBuffer<SampleType> &buffer) {
+    constexpr int lanes = 4;
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples == 0 || buffer.getNumChannels() == 0) return {};
+
+    // independent accumulators per lane, so the single pass vectorises without reassociating the sums
+    SampleType sumSquares[lanes] {}, minimum[lanes], maximum[lanes];
+    std::fill_n(minimum, lanes, std::numeric_limits<SampleType>::max());
+    std::fill_n(maximum, lanes, std::numeric_limits<SampleType>::lowest());
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        auto data = buffer.getReadPointer(channel);
+        int sample = 0;
+        for (; sample + lanes <= numSamples; sample += lanes) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                const SampleType x = data[sample + lane];
+                sumSquares[lane] += x * x;
+                minimum[lane] = std::min(minimum[lane], x);
+                maximum[lane] = std::max(maximum[lane], x);
+            }
+        }
+        for (; sample < numSamples; ++sample) {
+            sumSquares[0] += data[sample] * data[sample];
+            minimum[0] = std::min(minimum[0], data[sample]);
+            maximum[0] = std::max(maximum[0], data[sample]);
+        }
     }
+
+    LevelSummary summary;
+    summary.minimum = (float) *std::min_element(minimum, minimum + lanes);
+    summary.maximum = (float) *std::max_element(maximum, maximum + lanes);
+    summary.peak = std::max(std::abs(summary.minimum), std::abs(summary.maximum));
+
+    const SampleType totalSquares = (sumSquares[0] + sumSquares[1]) + (sumSquares[2] + sumSquares[3]);
+    summary.rms = (float) std::sqrt(totalSquares / (SampleType) (numSamples * buffer.getNumChannels()));
+    return summary;
 }
+
+size_t LevelAnalyser::getSizeInBytes() const {
+    return sizeof(history);
+}
+
+template void LevelAnalyser::processBlock<float>(const juce::AudioBuffer<float>&);
+template void LevelAnalyser::processBlock<double>(const juce::AudioBuffer<double>&);
+template LevelSummary LevelAnalyser::analyse<float>(const juce::AudioBuffer<float>&);
+template LevelSummary LevelAnalyser::analyse<double>(const juce::AudioBuffer<double>&);
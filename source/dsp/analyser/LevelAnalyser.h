@@ -12,17 +12,40 @@ enum LevelType{
     PEAK
 };
 
+struct LevelSummary {
+    float peak = 0.f;
+    float rms = 0.f;
+    float minimum = 0.f;
+    float maximum = 0.f;
+
+    float getLevel(LevelType type) const { return type == PEAK ? peak : rms; }
+};
+
+/*  Writes one summary per processed block into a lock-free single-producer single-consumer history, so the UI sees
+ *  every block since its last frame instead of whatever value happened to be current. The audio thread only
+ *  measures; holding and decaying the level is left to the reader (see LevelMeter).
+ */
 class LevelAnalyser {
 public:
-    void processBlock(juce::AudioBuffer<float>& buffer);
-    void setLevelType(LevelType newLevelType);
-    float getCurrentLevel();
+    template <typename SampleType>
+    void processBlock(const juce::AudioBuffer<SampleType>& buffer);
 
-private:
-    std::atomic<float> currentRMS;
-    std::atomic<float> currentPeak;
+    // reader side, one thread only; returns the number of summaries copied, oldest first
+    int readHistory(LevelSummary* destination, int maxSummaries);
+    int getNumDroppedSummaries() const;
+    size_t getSizeInBytes() const;
 
-    LevelType levelType = PEAK;
+    // measured in the sample type of the buffer, the summary is float for the UI
+    template <typename SampleType>
+    static LevelSummary analyse(const juce::AudioBuffer<SampleType>& buffer);
+
+    // 128 sample blocks at 48 kHz fill this in about 2.7 s, far longer than any frame
+    static constexpr int historySize = 1024;
+
+private:
+    juce::AbstractFifo fifo {historySize};
+    std::array<LevelSummary, historySize> history;
+    std::atomic<int> droppedSummaries {0};
 };
 
 
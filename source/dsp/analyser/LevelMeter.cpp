@@ -0,0 +1,33 @@
+#include "LevelMeter.h"
+
+LevelMeter::LevelMeter(LevelType type) : levelType(type) {
+}
+
+float LevelMeter::update(LevelAnalyser &analyser, double timeInMilliseconds) {
+    const int numSummaries = analyser.readHistory(pendingSummaries.data(), (int) pendingSummaries.size());
+
+    float blockLevel = 0.f;
+    for (int i = 0; i < numSummaries; ++i)
+        blockLevel = juce::jmax(blockLevel, pendingSummaries[(size_t) i].getLevel(levelType));
+
+    const double elapsed = lastUpdateTime < 0. ? 0. : timeInMilliseconds - lastUpdateTime;
+    lastUpdateTime = timeInMilliseconds;
+
+    if (timeInMilliseconds >= holdEndTime)
+        level *= (float) std::exp2(-elapsed / decayHalfLifeInMilliseconds);
+
+    if (numSummaries > 0 && blockLevel >= level) {
+        level = blockLevel;
+        holdEndTime = timeInMilliseconds + holdTimeInMilliseconds;
+    }
+
+    return level;
+}
+
+float LevelMeter::getLevel() const {
+    return level;
+}
+
+void LevelMeter::setLevelType(LevelType newLevelType) {
+    levelType = newLevelType;
+}
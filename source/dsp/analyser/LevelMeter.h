@@ -0,0 +1,30 @@
+#ifndef VAESYNTH_LEVELMETER_H
+#define VAESYNTH_LEVELMETER_H
+
+#include "JuceHeader.h"
+#include "LevelAnalyser.h"
+
+/*  Reader side of a LevelAnalyser for the UI. Every update drains the summaries written since the last one, holds
+ *  the highest level for a moment and then lets it fall off exponentially. Use it from a single thread, such as the
+ *  render callback.
+ */
+class LevelMeter {
+public:
+    explicit LevelMeter(LevelType type = PEAK);
+
+    float update(LevelAnalyser& analyser, double timeInMilliseconds);
+    float getLevel() const;
+    void setLevelType(LevelType newLevelType);
+
+private:
+    LevelType levelType;
+    float level = 0.f;
+    double holdEndTime = 0.;
+    double lastUpdateTime = -1.;
+    std::array<LevelSummary, LevelAnalyser::historySize> pendingSummaries;
+
+    static constexpr double holdTimeInMilliseconds = 30.;
+    static constexpr double decayHalfLifeInMilliseconds = 60.;
+};
+
+#endif //VAESYNTH_LEVELMETER_H
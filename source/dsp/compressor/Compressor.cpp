@@ -6,81 +6,71 @@
 //
 
 #include "Compressor.h"
+#include "../utils/MemoryUsage.h"
 #include "../utils/utils.h"
 
-Compressor::Compressor() : envelope(parameter.attackTime, parameter.releaseTime){
+template <typename SampleType>
+Compressor<SampleType>::Compressor() : envelope(parameter.attackTime, parameter.releaseTime){
 }
 
-Compressor::~Compressor() = default;
+template <typename SampleType>
+Compressor<SampleType>::~Compressor() = default;
 
-void Compressor::prepare(const juce::dsp::ProcessSpec &spec) {
+template <typename SampleType>
+void Compressor<SampleType>::prepare(const juce::dsp::ProcessSpec &spec) {
     envelope.prepare(spec);
-    autoMakeUpGain.BufferSize = (int) ((unsigned int) (spec.sampleRate/spec.maximumBlockSize) * spec.maximumBlockSize);
-    autoMakeUpGain.inputBuffer.setSize(1, autoMakeUpGain.BufferSize);
-    autoMakeUpGain.outputBuffer.setSize(1, autoMakeUpGain.BufferSize);
-    autoMakeUpGain.inputBufferIndex = 0;
-    autoMakeUpGain.outputBufferIndex = 0;
+    // one second of history for the auto make-up gain
+    autoMakeUpGain.inputLevel.prepare((int) spec.sampleRate);
+    autoMakeUpGain.outputLevel.prepare((int) spec.sampleRate);
+
+    gainBuffer.assign(spec.maximumBlockSize, 1.f);
+    gainTable.assign((size_t) ((gainTableMaxDecibels - gainTableMinDecibels) * gainTableStepsPerDecibel) + 1, 1.f);
+    updateGainTable();
+    gainTableNeedsUpdate.store(false);
+}
+
+template <typename SampleType>
+void Compressor<SampleType>::release() {
+    envelope.release();
+    autoMakeUpGain.inputLevel.release();
+    autoMakeUpGain.outputLevel.release();
+    gainBuffer = {};
+    gainTable = {};
+    // the table has to be rebuilt by the next prepare
+    gainTableNeedsUpdate.store(true);
 }
 
-void Compressor::processBlock(juce::AudioBuffer<float> &buffer){
+template <typename SampleType>
+void Compressor<SampleType>::processBlock(juce::AudioBuffer<SampleType> &buffer){
+    const int numSamples = buffer.getNumSamples();
+
+    if (gainTableNeedsUpdate.exchange(false))
+        updateGainTable();
+
     envelope.processBlock(buffer);
     
     if (parameter.autoMakeUpGain){
-        copyAutoMakeUpBuffer(autoMakeUpGain.inputBuffer, buffer, true);
-        autoMakeUpGain.inputGain = autoMakeUpGain.inputBuffer.getRMSLevel(0, 0, autoMakeUpGain.inputBuffer.getNumSamples());
+        pushAutoMakeUpSamples(autoMakeUpGain.inputLevel, buffer);
+        autoMakeUpGain.inputGain = autoMakeUpGain.inputLevel.getRMSLevel();
     }
-    
-    for (int i = 0; i < buffer.getNumChannels(); i++){
-        for (int j = 0; j < buffer.getNumSamples(); j++){
-            if (parameter.compType == CompressorType::Upward){
-                if (2*(utils::amp2dB(envelope.getSample((unsigned long) j)) - parameter.threshold) > parameter.knee){
-                    float controlVoltage;
-                    controlVoltage = (1/parameter.ratio-1)*(utils::amp2dB(envelope.getSample((unsigned long) j))-parameter.threshold);
-                    controlVoltage = std::max(controlVoltage, (-parameter.range));
-                    if (! parameter.autoMakeUpGain) buffer.setSample(i, j, utils::dB2amp(controlVoltage + parameter.makeUpGain)*buffer.getSample(i, j));
-                    else buffer.setSample(i, j, utils::dB2amp(controlVoltage)*buffer.getSample(i, j));
-                }
-                else if (2*std::abs(utils::amp2dB(envelope.getSample((unsigned long) j)) - parameter.threshold) <= parameter.knee){
-                    float controlVoltage;
-                    controlVoltage = ((1/parameter.ratio)-1) * (std::pow(utils::amp2dB(envelope.getSample((unsigned long) j)) - parameter.threshold + parameter.knee/2.f, 2.f)) / (2.f*parameter.knee);
-                    controlVoltage = std::max(controlVoltage, (-parameter.range));
-                    if (! parameter.autoMakeUpGain) buffer.setSample(i, j, utils::dB2amp(controlVoltage + parameter.makeUpGain)*buffer.getSample(i, j));
-                    else buffer.setSample(i, j, utils::dB2amp(controlVoltage)*buffer.getSample(i, j));
-                }
-                else{
-                    if (! parameter.autoMakeUpGain) buffer.setSample(i, j, utils::dB2amp(parameter.makeUpGain)*buffer.getSample(i, j));
-                }
-            }
-            else if (parameter.compType == CompressorType::Expander){
-                if (2*(parameter.threshold - utils::amp2dB(envelope.getSample((unsigned long) j))) > parameter.knee){
-                    float controlVoltage;
-                    controlVoltage = (1/parameter.ratio-1)*(parameter.threshold - utils::amp2dB(envelope.getSample((unsigned long) j)));
-                    controlVoltage = std::max(controlVoltage, (-parameter.range));
-                    if (! parameter.autoMakeUpGain) buffer.setSample(i, j, utils::dB2amp(controlVoltage + parameter.makeUpGain)*buffer.getSample(i, j));
-                    else buffer.setSample(i, j, utils::dB2amp(controlVoltage)*buffer.getSample(i, j));
-                }
-                else if (2*std::abs(utils::amp2dB(envelope.getSample((unsigned long) j)) - parameter.threshold) <= parameter.knee){
-                    float controlVoltage;
-                    controlVoltage = ((1/parameter.ratio)-1) * (std::pow(parameter.threshold - utils::amp2dB(envelope.getSample((unsigned long) j)) + parameter.knee/2.f, 2.f)) / (2.f*parameter.knee);
-                    controlVoltage = std::max(controlVoltage, (-parameter.range));
-                    if (! parameter.autoMakeUpGain) buffer.setSample(i, j, utils::dB2amp(controlVoltage + parameter.makeUpGain)*buffer.getSample(i, j));
-                    else buffer.setSample(i, j, utils::dB2amp(controlVoltage)*buffer.getSample(i, j));
-                }
-                else{
-                    if (! parameter.autoMakeUpGain) buffer.setSample(i, j, utils::dB2amp(parameter.makeUpGain)*buffer.getSample(i, j));
-                }
-            }
-        }
+
+    computeGain(numSamples);
+
+    // the gain is computed in float whatever the signal type, so it is applied with a plain loop
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+        auto data = buffer.getWritePointer(channel);
+        for (int i = 0; i < numSamples; i++)
+            data[i] *= (SampleType) gainBuffer[(size_t) i];
     }
     
     if (parameter.autoMakeUpGain){
-        copyAutoMakeUpBuffer(autoMakeUpGain.outputBuffer, buffer, false);
-        autoMakeUpGain.outputGain = autoMakeUpGain.outputBuffer.getRMSLevel(0, 0, autoMakeUpGain.outputBuffer.getNumSamples());
+        pushAutoMakeUpSamples(autoMakeUpGain.outputLevel, buffer);
+        autoMakeUpGain.outputGain = autoMakeUpGain.outputLevel.getRMSLevel();
 
         parameter.makeUpGain = (autoMakeUpGain.inputGain > 0.f && autoMakeUpGain.inputGain > autoMakeUpGain.outputGain) ? autoMakeUpGain.inputGain / autoMakeUpGain.outputGain : 1.f;
         
         for (int i=0; i < buffer.getNumChannels(); ++i)
-            buffer.applyGainRamp (i, 0, buffer.getNumSamples(), autoMakeUpGain.previousMakeUpGain, parameter.makeUpGain);
+            buffer.applyGainRamp (i, 0, buffer.getNumSamples(), (SampleType) autoMakeUpGain.previousMakeUpGain, (SampleType) parameter.makeUpGain);
 
         autoMakeUpGain.previousMakeUpGain = parameter.makeUpGain;
         parameter.makeUpGain = utils::amp2dB(parameter.makeUpGain);
@@ -88,102 +78,170 @@ void Compressor::processBlock(juce::AudioBuffer<float> &buffer){
     else autoMakeUpGain.previousMakeUpGain = utils::dB2amp(parameter.makeUpGain);
 }
 
-void Compressor::setThreshold(float newThreshold){
+template <typename SampleType>
+void Compressor<SampleType>::setThreshold(float newThreshold){
     parameter.threshold = newThreshold;
+    gainTableNeedsUpdate.store(true);
 }
 
-[[maybe_unused]] float Compressor::getThreshold() const{
+template <typename SampleType>
+[[maybe_unused]] float Compressor<SampleType>::getThreshold() const{
     return parameter.threshold;
 }
 
-void Compressor::setRatio(float newRatio){
+template <typename SampleType>
+void Compressor<SampleType>::setRatio(float newRatio){
     parameter.ratio = newRatio;
+    gainTableNeedsUpdate.store(true);
 }
 
-float Compressor::getRatio() const{
+template <typename SampleType>
+float Compressor<SampleType>::getRatio() const{
     return parameter.ratio;
 }
 
-void Compressor::setKnee(float newKnee){
+template <typename SampleType>
+void Compressor<SampleType>::setKnee(float newKnee){
     parameter.knee = newKnee;
+    gainTableNeedsUpdate.store(true);
 }
 
-float Compressor::getKnee() const{
+template <typename SampleType>
+float Compressor<SampleType>::getKnee() const{
     return parameter.knee;
 }
 
-void Compressor::setMakeUpGain(float newMakeUpGain){
+template <typename SampleType>
+void Compressor<SampleType>::setMakeUpGain(float newMakeUpGain){
     parameter.makeUpGain = newMakeUpGain;
 }
 
-float Compressor::getMakeUpGain() const{
+template <typename SampleType>
+float Compressor<SampleType>::getMakeUpGain() const{
     return parameter.makeUpGain;
 }
 
-void Compressor::setRange(float newRange){
+template <typename SampleType>
+void Compressor<SampleType>::setRange(float newRange){
     parameter.range = newRange;
+    gainTableNeedsUpdate.store(true);
 }
 
-float Compressor::getRange() const{
+template <typename SampleType>
+float Compressor<SampleType>::getRange() const{
     return parameter.range;
 }
 
-void Compressor::setAttackTime(float newAttackTime){
+template <typename SampleType>
+void Compressor<SampleType>::setAttackTime(float newAttackTime){
     parameter.attackTime = newAttackTime;
     envelope.setAttackTime(newAttackTime);
 }
 
-float Compressor::getAttackTime() const{
+template <typename SampleType>
+float Compressor<SampleType>::getAttackTime() const{
     return parameter.attackTime;
 }
 
-void Compressor::setReleaseTime(float newReleaseTime){
+template <typename SampleType>
+void Compressor<SampleType>::setReleaseTime(float newReleaseTime){
     parameter.releaseTime = newReleaseTime;
     envelope.setReleaseTime(newReleaseTime);
 }
 
-float Compressor::getReleaseTime() const {
+template <typename SampleType>
+float Compressor<SampleType>::getReleaseTime() const {
     return parameter.releaseTime;
 }
 
-void Compressor::setAutoMakeUpGain(bool newBool) {
+template <typename SampleType>
+void Compressor<SampleType>::setAutoMakeUpGain(bool newBool) {
     parameter.autoMakeUpGain = newBool;
 }
 
-bool Compressor::getAutoMakeUpGain() const{
+template <typename SampleType>
+bool Compressor<SampleType>::getAutoMakeUpGain() const{
     return parameter.autoMakeUpGain;
 }
 
-void Compressor::setCompressionTypeIndex(int newCompressionTypeIndex) {
+template <typename SampleType>
+void Compressor<SampleType>::setCompressionTypeIndex(int newCompressionTypeIndex) {
     if (newCompressionTypeIndex == 0)
         parameter.compType = CompressorType::Upward;
     else if (newCompressionTypeIndex == 1)
         parameter.compType = CompressorType::Expander;
+    gainTableNeedsUpdate.store(true);
 }
 
-int Compressor::getCompressionTypeIndex() const {
+template <typename SampleType>
+int Compressor<SampleType>::getCompressionTypeIndex() const {
     if (parameter.compType == CompressorType::Expander)
         return 1;
     else
         return 0;
 }
 
-void Compressor::copyAutoMakeUpBuffer(juce::AudioBuffer<float>& target, juce::AudioBuffer<float>& source, bool input) {
-    auto writePointer = target.getWritePointer(0);
-    for (int channel = 0; channel < source.getNumChannels(); channel++){
-        auto readPointer = source.getReadPointer(channel);
-        if (input){
-            for (int sample = 0; sample < source.getNumSamples(); sample++){
-                writePointer[autoMakeUpGain.inputBufferIndex] = readPointer[sample];
-                autoMakeUpGain.inputBufferIndex++;
-                if (autoMakeUpGain.inputBufferIndex >= autoMakeUpGain.BufferSize) autoMakeUpGain.inputBufferIndex = 0;
-            }
-        } else {
-            for (int sample = 0; sample < source.getNumSamples(); sample++){
-                writePointer[autoMakeUpGain.outputBufferIndex] = readPointer[sample];
-                autoMakeUpGain.outputBufferIndex++;
-                if (autoMakeUpGain.outputBufferIndex >= autoMakeUpGain.BufferSize) autoMakeUpGain.outputBufferIndex = 0;
-            }
-        }
+template <typename SampleType>
+void Compressor<SampleType>::pushAutoMakeUpSamples(RunningRMS& level, juce::AudioBuffer<SampleType>& source) {
+    for (int channel = 0; channel < source.getNumChannels(); channel++)
+        level.pushSamples(source.getReadPointer(channel), source.getNumSamples());
+}
+
+template <typename SampleType>
+void Compressor<SampleType>::updateGainTable() {
+    for (size_t i = 0; i < gainTable.size(); i++){
+        const float levelInDecibels = gainTableMinDecibels + (float) i / gainTableStepsPerDecibel;
+        gainTable[i] = computeControlVoltage(levelInDecibels);
+    }
+    utils::dB2amp(gainTable.data(), gainTable.data(), (int) gainTable.size());
+}
+
+template <typename SampleType>
+float Compressor<SampleType>::computeControlVoltage(float levelInDecibels) const {
+    // distance into the compressed region: above the threshold for Upward, below it for Expander
+    const float overshoot = (parameter.compType == CompressorType::Upward) ? levelInDecibels - parameter.threshold
+                                                                            : parameter.threshold - levelInDecibels;
+    float controlVoltage;
+
+    if (2*overshoot > parameter.knee)
+        controlVoltage = (1/parameter.ratio-1)*overshoot;
+    else if (parameter.knee > 0.f && 2*std::abs(overshoot) <= parameter.knee)
+        controlVoltage = (1/parameter.ratio-1) * std::pow(overshoot + parameter.knee/2.f, 2.f) / (2.f*parameter.knee);
+    else
+        return 0.f;
+
+    return std::max(controlVoltage, (-parameter.range));
+}
+
+template <typename SampleType>
+void Compressor<SampleType>::computeGain(int numSamples) {
+    auto envelopeData = envelope.getReadPointer();
+    auto gain = gainBuffer.data();
+
+    // detector level in dB, clamped to the table range so the lookup needs no branches
+    const float minimumLevel = utils::dB2amp(gainTableMinDecibels);
+    for (int i = 0; i < numSamples; i++)
+        gain[i] = std::max((float) std::abs(envelopeData[i]), minimumLevel);
+    utils::amp2dB(gain, gain, numSamples);
+
+    const float maxPosition = (float) (gainTable.size() - 1);
+    const auto table = gainTable.data();
+    for (int i = 0; i < numSamples; i++){
+        const float position = juce::jlimit(0.f, maxPosition, (gain[i] - gainTableMinDecibels) * gainTableStepsPerDecibel);
+        const int index = std::min((int) position, (int) maxPosition - 1);
+        const float fraction = position - (float) index;
+        gain[i] = table[index] + fraction * (table[index + 1] - table[index]);
     }
+
+    if (! parameter.autoMakeUpGain)
+        juce::FloatVectorOperations::multiply(gain, utils::dB2amp(parameter.makeUpGain), numSamples);
 }
+
+template <typename SampleType>
+size_t Compressor<SampleType>::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(gainTable) + MemoryUsage::getSizeInBytes(gainBuffer) + envelope.getSizeInBytes()
+           + autoMakeUpGain.inputLevel.getSizeInBytes() + autoMakeUpGain.outputLevel.getSizeInBytes();
+}
+
+template class Compressor<float>;
+template class Compressor<double>;
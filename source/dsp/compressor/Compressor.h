@@ -9,6 +9,7 @@
 
 #include <JuceHeader.h>
 #include "../utils/Envelope.h"
+#include "../utils/RunningRMS.h"
 
 enum CompressorType {
     Upward,
@@ -28,24 +29,24 @@ struct CompressorParameter{
 };
 
 struct AutoMakeUpGain{
-    juce::AudioBuffer<float> inputBuffer;
-    juce::AudioBuffer<float> outputBuffer;
-    int inputBufferIndex;
-    int outputBufferIndex;
-    int BufferSize;
+    RunningRMS inputLevel;
+    RunningRMS outputLevel;
     float inputGain;
     float outputGain;
     float previousMakeUpGain;
 };
 
 
+// the signal and its envelope are SampleType, the gain computer works on float dB values with the fast math kernels
+template <typename SampleType>
 class Compressor{
 public:
     Compressor();
     ~Compressor();
 
     void prepare(const juce::dsp::ProcessSpec &spec);
-    void processBlock(juce::AudioBuffer<float>& buffer);
+    void release();
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
 
 public:
     void setThreshold(float newThreshold);
@@ -76,13 +77,27 @@ public:
     void setCompressionTypeIndex(int newCompressionTypeIndex);
 
     int getCompressionTypeIndex() const;
+
+    size_t getSizeInBytes() const;
     
 private:
     CompressorParameter parameter {0.f, 4.0f, 4.0f, 0.0f, 80.0f, 0.05f, 0.3f, true, Upward};
     AutoMakeUpGain autoMakeUpGain;
-    Envelope envelope;
-    
-    void copyAutoMakeUpBuffer(juce::AudioBuffer<float>& target, juce::AudioBuffer<float>& source, bool input);
+    Envelope<SampleType> envelope;
+
+    // static curve sampled in dB steps and stored as linear gain, rebuilt on the audio thread when the curve changes
+    std::vector<float> gainTable;
+    std::vector<float> gainBuffer;
+    std::atomic<bool> gainTableNeedsUpdate {true};
+
+    static constexpr float gainTableMinDecibels = -144.f;
+    static constexpr float gainTableMaxDecibels = 24.f;
+    static constexpr float gainTableStepsPerDecibel = 4.f;
+
+    void pushAutoMakeUpSamples(RunningRMS& level, juce::AudioBuffer<SampleType>& source);
+    void updateGainTable();
+    float computeControlVoltage(float levelInDecibels) const;
+    void computeGain(int numSamples);
 };
 
 #endif
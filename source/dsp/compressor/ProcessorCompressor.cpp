@@ -7,34 +7,56 @@
 
 #include "ProcessorCompressor.h"
 
-ProcessorCompressor::ProcessorCompressor(juce::AudioProcessorValueTreeState &apvts): compressor(){
-    compressor.setThreshold(apvts.getRawParameterValue(PluginParameters::COMP_THRESHOLD_ID.getParamID())->load());
-    compressor.setRatio(apvts.getRawParameterValue(PluginParameters::COMP_RATIO_ID.getParamID())->load());
-    compressor.setMakeUpGain(apvts.getRawParameterValue(PluginParameters::COMP_MAKEUPGAIN_ID.getParamID())->load());
+ProcessorCompressor::ProcessorCompressor(juce::AudioProcessorValueTreeState &apvts) {
+    makeUpGainParameter = apvts.getRawParameterValue(PluginParameters::COMP_MAKEUPGAIN_ID.getParamID())->load();
+    const float threshold = apvts.getRawParameterValue(PluginParameters::COMP_THRESHOLD_ID.getParamID())->load();
+    const float ratio = apvts.getRawParameterValue(PluginParameters::COMP_RATIO_ID.getParamID())->load();
+
+    compressors.forEach([&] (auto& compressor) {
+        compressor.setThreshold(threshold);
+        compressor.setRatio(ratio);
+        compressor.setAutoMakeUpGain(makeUpGainParameter < 0.f);
+        if (makeUpGainParameter >= 0.f) compressor.setMakeUpGain(makeUpGainParameter);
+    });
 }
 
 ProcessorCompressor::~ProcessorCompressor() = default;
 
-void ProcessorCompressor::prepare(const juce::dsp::ProcessSpec &spec){
-    compressor.prepare(spec);
+void ProcessorCompressor::prepare(const juce::dsp::ProcessSpec &spec, juce::AudioProcessor::ProcessingPrecision precision){
+    compressors.prepare(precision, spec);
 }
 
-void ProcessorCompressor::processBlock(juce::AudioBuffer<float>& buffer){
-    compressor.processBlock(buffer);
+template <typename SampleType>
+void ProcessorCompressor::processBlock(juce::AudioBuffer<SampleType>& buffer){
+    compressors.get<SampleType>().processBlock(buffer);
 }
 
-void ProcessorCompressor::parameterChanged(const juce::String &parameterID, float newValue){
-    if (parameterID == PluginParameters::COMP_THRESHOLD_ID.getParamID()) {
-        compressor.setThreshold(newValue);
-    } else if (parameterID == PluginParameters::COMP_RATIO_ID.getParamID()) {
-        compressor.setRatio(newValue);
-    } else if (parameterID == PluginParameters::COMP_MAKEUPGAIN_ID.getParamID()) {
-        if (newValue == -0.1f){
-            compressor.setAutoMakeUpGain(true);
-        }
-        else {
-            compressor.setAutoMakeUpGain(false);
-            compressor.setMakeUpGain(newValue);
+void ProcessorCompressor::setParameters(const ParameterSnapshot &snapshot){
+    const bool makeUpGainChanged = snapshot.compMakeUpGain != makeUpGainParameter;
+    makeUpGainParameter = snapshot.compMakeUpGain;
+
+    compressors.forEach([&] (auto& compressor) {
+        if (snapshot.compThreshold != compressor.getThreshold())
+            compressor.setThreshold(snapshot.compThreshold);
+        if (snapshot.compRatio != compressor.getRatio())
+            compressor.setRatio(snapshot.compRatio);
+
+        // the lowest makeup value (-0.1) selects the automatic makeup gain
+        if (makeUpGainChanged) {
+            if (makeUpGainParameter < 0.f){
+                compressor.setAutoMakeUpGain(true);
+            }
+            else {
+                compressor.setAutoMakeUpGain(false);
+                compressor.setMakeUpGain(makeUpGainParameter);
+            }
         }
-    }
+    });
 }
+
+size_t ProcessorCompressor::getSizeInBytes() const {
+    return compressors.getSizeInBytes();
+}
+
+template void ProcessorCompressor::processBlock<float>(juce::AudioBuffer<float>&);
+template void ProcessorCompressor::processBlock<double>(juce::AudioBuffer<double>&);
@@ -10,19 +10,24 @@
 
 #include <JuceHeader.h>
 #include "Compressor.h"
-#include "../../PluginParameters.h"
+#include "../utils/PerPrecision.h"
+#include "../../ParameterSnapshot.h"
 
 class ProcessorCompressor{
 public:
     explicit ProcessorCompressor(juce::AudioProcessorValueTreeState &apvts);
     ~ProcessorCompressor();
     
-    void prepare(const juce::dsp::ProcessSpec &spec);
-    void processBlock(juce::AudioBuffer<float>& buffer);
-    void parameterChanged(const juce::String &parameterID, float newValue);
+    void prepare(const juce::dsp::ProcessSpec &spec, juce::AudioProcessor::ProcessingPrecision precision);
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
+    void setParameters(const ParameterSnapshot& snapshot);
+    size_t getSizeInBytes() const;
 
 private:
-    Compressor compressor;
+    // both compressors follow the parameters, only the one for the host's precision is prepared
+    PerPrecision<Compressor> compressors;
+    float makeUpGainParameter = 0.f;
 };
 
 
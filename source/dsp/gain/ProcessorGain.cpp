@@ -4,20 +4,21 @@
 
 #include "ProcessorGain.h"
 
-void ProcessorGain::processInputBlock(juce::AudioBuffer<float> &buffer) {
-    buffer.applyGainRamp(0, buffer.getNumSamples(), inputGain.previousGain, inputGain.currentGain);
+template <typename SampleType>
+void ProcessorGain::processInputBlock(juce::AudioBuffer<SampleType> &buffer) {
+    buffer.applyGainRamp(0, buffer.getNumSamples(), (SampleType) inputGain.previousGain, (SampleType) inputGain.currentGain);
     inputGain.previousGain = inputGain.currentGain;
 }
 
-void ProcessorGain::processOutputBlock(juce::AudioBuffer<float> &buffer) {
-    buffer.applyGainRamp(0, buffer.getNumSamples(), outputGain.previousGain, outputGain.currentGain);
-    outputGain.previousGain = outputGain.currentGain;
+void ProcessorGain::setParameters(const ParameterSnapshot &snapshot) {
+    setGainInDecibels(inputGain, snapshot.inputGain);
 }
 
-void ProcessorGain::parameterChanged(const juce::String &parameterID, float newValue) {
-    if (parameterID == PluginParameters::INPUT_GAIN_ID.getParamID()) {
-        inputGain.currentGain = juce::Decibels::decibelsToGain(newValue);
-    } else if (parameterID == PluginParameters::OUTPUT_GAIN_ID.getParamID()) {
-        outputGain.currentGain = juce::Decibels::decibelsToGain(newValue);
-    }
+void ProcessorGain::setGainInDecibels(GainLevel &level, float newDecibels) {
+    if (level.decibels == newDecibels) return;
+    level.decibels = newDecibels;
+    level.currentGain = juce::Decibels::decibelsToGain(newDecibels);
 }
+
+template void ProcessorGain::processInputBlock<float>(juce::AudioBuffer<float>&);
+template void ProcessorGain::processInputBlock<double>(juce::AudioBuffer<double>&);
@@ -6,21 +6,24 @@
 #define VAESYNTH_PROCESSORGAIN_H
 
 #include "JuceHeader.h"
-#include "../../PluginParameters.h"
+#include "../../ParameterSnapshot.h"
 
 struct GainLevel{
+    float decibels = 0.f;
     float currentGain = 1.f;
     float previousGain = 1.f;
 };
 
 class ProcessorGain {
 public:
-    void processInputBlock(juce::AudioBuffer<float>& buffer);
-    void processOutputBlock(juce::AudioBuffer<float>& buffer);
-    void parameterChanged(const juce::String &parameterID, float newValue);
+    template <typename SampleType>
+    void processInputBlock(juce::AudioBuffer<SampleType>& buffer);
+    void setParameters(const ParameterSnapshot& snapshot);
 
 private:
-    GainLevel inputGain, outputGain;
+    static void setGainInDecibels(GainLevel& level, float newDecibels);
+
+    GainLevel inputGain;
 };
 
 
@@ -4,9 +4,24 @@
 
 #include "GrainDelay.h"
 #include "../../PluginParameters.h"
+#include "../utils/MemoryUsage.h"
+
+// parameter indices of the exported RNBO patch
+#if SCYCLONE_RNBO_GRAIN_DELAY
+namespace RnboGrainParameter {
+    constexpr RNBO::ParameterIndex position = 0;
+    constexpr RNBO::ParameterIndex size = 1;
+    constexpr RNBO::ParameterIndex pitch = 2;
+    constexpr RNBO::ParameterIndex interval = 3;
+}
+#endif
 
 GrainDelay::GrainDelay(const int no) : number(no) {
-    rnboObject.setParameterValue(0, 2.f);
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    rnboObject.setParameterValue(RnboGrainParameter::position, 2.f);
+#else
+    granularEngine.setPosition(2.f);
+#endif
 }
 
 GrainDelay::~GrainDelay() {
@@ -15,42 +30,119 @@ GrainDelay::~GrainDelay() {
 
 void GrainDelay::prepare(const juce::dsp::ProcessSpec &spec) {
     sampleRate = (int) spec.sampleRate;
-    auto samplesPerBlock = spec.maximumBlockSize;
-    rnboObject.prepareToProcess(sampleRate, static_cast<size_t> (samplesPerBlock));
+    maxBlockSize = juce::jmax(1, (int) spec.maximumBlockSize);
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    // prepared once at the maximum size, smaller blocks are processed without re-preparing
+    rnboObject.prepareToProcess(sampleRate, static_cast<size_t> (maxBlockSize));
+#else
+    granularEngine.prepare(spec);
+    conversionBuffer.assign((size_t) maxBlockSize, 0.f);
+#endif
 }
 
-void GrainDelay::processBlock(juce::AudioBuffer<float> &buffer) {
+void GrainDelay::release() {
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    // the exported patch has no way to give back its buffers, they are reused by the next prepareToProcess
+#else
+    granularEngine.release();
+    conversionBuffer = {};
+#endif
+}
+
+template <typename SampleType>
+void GrainDelay::processBlock(juce::AudioBuffer<SampleType> &buffer) {
 
     if (!isMuted) {
-        auto bufferSize = buffer.getNumSamples();
-        rnboObject.prepareToProcess(sampleRate,
-                                    static_cast<size_t> (bufferSize));
-
-        rnboObject.process(buffer.getArrayOfWritePointers(),
-                           static_cast<RNBO::Index> (buffer.getNumChannels()),
-                           buffer.getArrayOfWritePointers(),
-                           static_cast<RNBO::Index> (buffer.getNumChannels()),
-                           static_cast<RNBO::Index> (bufferSize));
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        const int bufferSize = buffer.getNumSamples();
+
+        for (int offset = 0; offset < bufferSize; offset += maxBlockSize) {
+            const int sliceSize = juce::jmin(maxBlockSize, bufferSize - offset);
+            processSlice(buffer, numChannels, offset, sliceSize);
+        }
     }
 }
 
-void GrainDelay::setParameterValue(std::atomic<float>* parameterToConnect, int rnboParameterIdx){
-    rnboObject.setParameterValue(rnboParameterIdx, parameterToConnect->load());
+template <typename SampleType>
+void GrainDelay::processSlice(juce::AudioBuffer<SampleType> &buffer, int numChannels, int offset, int numSamples) {
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    // the patch processes float and double buffers directly
+    std::array<SampleType*, maxChannels> channels {};
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels[(size_t) channel] = buffer.getWritePointer(channel, offset);
 
+    rnboObject.process(channels.data(),
+                       static_cast<RNBO::Index> (numChannels),
+                       channels.data(),
+                       static_cast<RNBO::Index> (numChannels),
+                       static_cast<RNBO::Index> (numSamples));
+#else
+    juce::ignoreUnused(numChannels);
+    auto data = buffer.getWritePointer(0, offset);
+    if constexpr (std::is_same_v<SampleType, float>) {
+        granularEngine.process(data, numSamples);
+    } else {
+        std::transform(data, data + numSamples, conversionBuffer.begin(), [] (SampleType x) { return (float) x; });
+        granularEngine.process(conversionBuffer.data(), numSamples);
+        std::copy(conversionBuffer.begin(), conversionBuffer.begin() + numSamples, data);
+    }
+#endif
 }
 
 void GrainDelay::setMuted(bool newState) {
     isMuted = newState;
 }
 
-void GrainDelay::parameterChanged(const juce::String &parameterID, float newValue) {
-    if (parameterID == PluginParameters::GRAIN_ON_OFF_NETWORK1_ID.getParamID() && number == 1)
-        setMuted(!(bool) newValue);
-    else if (parameterID == PluginParameters::GRAIN_ON_OFF_NETWORK2_ID.getParamID() && number == 2)
-        setMuted(!(bool) newValue);
-    else if ((parameterID == PluginParameters::GRAIN_NETWORK1_PITCH_ID.getParamID() && number == 1) || (parameterID == PluginParameters::GRAIN_NETWORK2_PITCH_ID.getParamID() && number == 2))
-        rnboObject.setParameterValue(2, newValue);
-    else if ((parameterID == PluginParameters::GRAIN_NETWORK1_SIZE_ID.getParamID() && number == 1 ) || (parameterID == PluginParameters::GRAIN_NETWORK2_SIZE_ID.getParamID() && number == 2))
-        rnboObject.setParameterValue(1, newValue);
-    else if ((parameterID == PluginParameters::GRAIN_NETWORK1_INTERVAL_ID.getParamID() && number == 1 ) || (parameterID == PluginParameters::GRAIN_NETWORK2_INTERVAL_ID.getParamID() && number == 2))
-        rnboObject.setParameterValue(3, newValue);}
+bool GrainDelay::isActive() const {
+    return !isMuted;
+}
+
+void GrainDelay::setParameters(const NetworkParameterSnapshot &snapshot) {
+    setMuted(!snapshot.grainOnOff);
+    // the cached values start as NaN, so the first snapshot always gets through
+    if (snapshot.grainPitch != pitch)
+        setPitch(snapshot.grainPitch);
+    if (snapshot.grainSize != grainSize)
+        setGrainSize(snapshot.grainSize);
+    if (snapshot.grainInterval != interval)
+        setInterval(snapshot.grainInterval);
+}
+
+void GrainDelay::setPitch(float newPitch) {
+    pitch = newPitch;
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    rnboObject.setParameterValue(RnboGrainParameter::pitch, newPitch);
+#else
+    granularEngine.setPitch(newPitch);
+#endif
+}
+
+void GrainDelay::setGrainSize(float newGrainSize) {
+    grainSize = newGrainSize;
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    rnboObject.setParameterValue(RnboGrainParameter::size, newGrainSize);
+#else
+    granularEngine.setGrainSize(newGrainSize);
+#endif
+}
+
+void GrainDelay::setInterval(float newInterval) {
+    interval = newInterval;
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    rnboObject.setParameterValue(RnboGrainParameter::interval, newInterval);
+#else
+    granularEngine.setInterval(newInterval);
+#endif
+}
+
+size_t GrainDelay::getSizeInBytes() const {
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    // the patch gives no access to its data refs, the delay lines dominate so they stand in for the whole object
+    return (size_t) (maxChannels * rnboDelayLengthInSeconds * sampleRate) * sizeof(double);
+#else
+    return granularEngine.getSizeInBytes() + MemoryUsage::getSizeInBytes(conversionBuffer);
+#endif
+}
+
+template void GrainDelay::processBlock<float>(juce::AudioBuffer<float>&);
+template void GrainDelay::processBlock<double>(juce::AudioBuffer<double>&);
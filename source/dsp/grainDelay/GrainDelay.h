@@ -2,8 +2,13 @@
 // Created by schee on 22/03/2023.
 //
 #include <JuceHeader.h>
+#include "../../ParameterSnapshot.h"
+
+#if SCYCLONE_RNBO_GRAIN_DELAY
 #include "../../../modules/RnboExport/rnbo/RNBO.h"
-#include "../../PluginParameters.h"
+#else
+#include "GranularEngine.h"
+#endif
 
 #ifndef GITMODULES_GRAINDELAY_H
 #define GITMODULES_GRAINDELAY_H
@@ -15,17 +20,40 @@ public:
     ~GrainDelay();
 
     void prepare(const juce::dsp::ProcessSpec &spec);
-    void processBlock(juce::AudioBuffer<float>& buffer);
-    void parameterChanged(const juce::String &parameterID, float newValue);
-
-    void setParameterValue(std::atomic<float>* parameterToConnect, int rnboParameterIdx);
+    void release();
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
+    void setParameters(const NetworkParameterSnapshot& snapshot);
     void setMuted(bool newState);
+    bool isActive() const;
+    size_t getSizeInBytes() const;
+
+private:
+    template <typename SampleType>
+    void processSlice(juce::AudioBuffer<SampleType>& buffer, int numChannels, int offset, int numSamples);
+    void setPitch(float newPitch);
+    void setGrainSize(float newGrainSize);
+    void setInterval(float newInterval);
 
 private:
     int sampleRate = 48000;
+    int maxBlockSize = 512;
+    static constexpr int maxChannels = 2;
+#if SCYCLONE_RNBO_GRAIN_DELAY
+    // the exported patch allocates two Float64 delay lines of this length, see gen_01_del_in*_evaluateSizeExpr
+    static constexpr int rnboDelayLengthInSeconds = 2;
+#endif
+#if SCYCLONE_RNBO_GRAIN_DELAY
     RNBO::CoreObject rnboObject;
-    std::unordered_map<juce::String, RNBO::ParameterIndex> apvtsParamIdToRnboParamIndex;
+#else
+    GranularEngine granularEngine;
+    // the engine is float only, a double precision slice is converted through here
+    std::vector<float> conversionBuffer;
+#endif
     bool isMuted = true;
+    float pitch = std::numeric_limits<float>::quiet_NaN();
+    float grainSize = std::numeric_limits<float>::quiet_NaN();
+    float interval = std::numeric_limits<float>::quiet_NaN();
     int number;
 };
 
@@ -0,0 +1,350 @@
+#include "GranularEngine.h"
+#include "../utils/FastMath.h"
+#include "../utils/MemoryUsage.h"
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SCYCLONE_GRAIN_SSE2 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define SCYCLONE_GRAIN_NEON 1
+#endif
+
+GranularEngine::GranularEngine(int maxGrains) : maxGrains(juce::jmax(1, maxGrains)) {
+    grains.age.resize((size_t) this->maxGrains);
+    grains.size.resize((size_t) this->maxGrains);
+    grains.inverseSize.resize((size_t) this->maxGrains);
+    grains.startDelay.resize((size_t) this->maxGrains);
+    grains.pitchScaled.resize((size_t) this->maxGrains);
+    grains.startOffset.resize((size_t) this->maxGrains);
+
+    // Hann window over one grain, with a guard point for the interpolation
+    windowTable.resize(windowTableSize + 1);
+    for (int i = 0; i <= windowTableSize; ++i) {
+        auto phase = (float) i / (float) windowTableSize;
+        windowTable[(size_t) i] = 0.5f * (1.f - std::cos(juce::MathConstants<float>::twoPi * phase));
+    }
+}
+
+void GranularEngine::prepare(const juce::dsp::ProcessSpec &spec) {
+    sampleRate = spec.sampleRate;
+
+    // a whole block is written before the grains read it, so the history needs one block of headroom
+    auto historySize = juce::nextPowerOfTwo((int) (historyLengthInSeconds * sampleRate) + (int) spec.maximumBlockSize + 2);
+    history.assign((size_t) historySize, 0.f);
+    historyMask = historySize - 1;
+
+    outputAccumulator.assign(spec.maximumBlockSize, 0.f);
+    windowAccumulator.assign(spec.maximumBlockSize, 0.f);
+
+    reset();
+}
+
+void GranularEngine::reset() {
+    std::fill(history.begin(), history.end(), 0.f);
+    historyWritePosition = 0;
+    numActiveGrains = 0;
+    intervalCounter = 0.f;
+    outputGain = 0.f;
+}
+
+void GranularEngine::release() {
+    history = {};
+    historyMask = 0;
+    historyWritePosition = 0;
+    outputAccumulator = {};
+    windowAccumulator = {};
+    numActiveGrains = 0;
+}
+
+void GranularEngine::process(float *data, int numSamples) {
+    jassert(numSamples <= (int) outputAccumulator.size());
+
+    writeHistory(data, numSamples);
+
+    juce::FloatVectorOperations::clear(outputAccumulator.data(), numSamples);
+    juce::FloatVectorOperations::clear(windowAccumulator.data(), numSamples);
+
+    spawnGrains(numSamples);
+
+    for (int grain = 0; grain < numActiveGrains; grain += grainsPerStep)
+        renderGrains(grain, numSamples);
+
+    removeFinishedGrains();
+    normalise(data, numSamples);
+
+    historyWritePosition = (historyWritePosition + numSamples) & historyMask;
+}
+
+void GranularEngine::setPosition(float newPositionInMs) {
+    position.store(juce::jlimit(1.f, 500.f, newPositionInMs));
+}
+
+void GranularEngine::setGrainSize(float newGrainSizeInMs) {
+    grainSize.store(juce::jlimit(10.f, 500.f, newGrainSizeInMs));
+}
+
+void GranularEngine::setPitch(float newPitchInSemitones) {
+    pitch.store(juce::jlimit(-12.f, 12.f, newPitchInSemitones));
+}
+
+void GranularEngine::setInterval(float newIntervalInMs) {
+    interval.store(juce::jlimit(1.f, 50.f, newIntervalInMs));
+}
+
+int GranularEngine::getNumActiveGrains() const {
+    return numActiveGrains;
+}
+
+void GranularEngine::writeHistory(const float *data, int numSamples) {
+    const int firstPart = juce::jmin(numSamples, (int) history.size() - historyWritePosition);
+    std::copy(data, data + firstPart, history.begin() + historyWritePosition);
+    std::copy(data + firstPart, data + numSamples, history.begin());
+}
+
+void GranularEngine::spawnGrains(int numSamples) {
+    const float limit = msToSamples(interval.load());
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+        intervalCounter += 1.f;
+        if (limit > 0.f && intervalCounter >= limit)
+            intervalCounter = 0.f;
+        if (intervalCounter == 1.f)
+            startGrain(sample);
+    }
+}
+
+void GranularEngine::startGrain(int offset) {
+    if (numActiveGrains >= maxGrains) return;
+
+    const auto grain = (size_t) numActiveGrains++;
+    const float size = juce::jmax(1.f, msToSamples(grainSize.load()));
+    const float pitchScaled = std::exp2(pitch.load() / 12.f) - 1.f;
+    const float maxDelay = (float) (historyLengthInSeconds * sampleRate);
+
+    grains.age[grain] = 1.f;
+    grains.size[grain] = size;
+    grains.inverseSize[grain] = 1.f / size;
+    grains.pitchScaled[grain] = pitchScaled;
+    grains.startOffset[grain] = offset;
+    grains.startDelay[grain] = juce::jmin(maxDelay, msToSamples(position.load()) * random.nextFloat()
+                                                    + juce::jmax(size * pitchScaled, 0.f));
+}
+
+void GranularEngine::renderGrains(int firstGrain, int numSamples) {
+    // one lane per grain, lanes past the last active grain keep an empty sample range and contribute nothing
+    float ageAtBlockStart[grainsPerStep] {}, windowScale[grainsPerStep] {};
+    float startDelay[grainsPerStep] {}, pitchScaled[grainsPerStep] {};
+    int startSample[grainsPerStep] {}, endSample[grainsPerStep] {};
+    int firstSample = numSamples, lastSample = 0;
+
+    const int numLanes = juce::jmin(grainsPerStep, numActiveGrains - firstGrain);
+    for (int lane = 0; lane < numLanes; ++lane) {
+        const auto index = (size_t) (firstGrain + lane);
+        const int numRemaining = juce::jmax(0, (int) std::ceil(grains.size[index] - grains.age[index]));
+
+        // the age grows by one per sample, so within the block it is ageAtBlockStart + sample
+        startSample[lane] = grains.startOffset[index];
+        endSample[lane] = juce::jmin(numSamples, startSample[lane] + numRemaining);
+        ageAtBlockStart[lane] = grains.age[index] - (float) startSample[lane];
+        windowScale[lane] = grains.inverseSize[index] * (float) windowTableSize;
+        startDelay[lane] = grains.startDelay[index];
+        pitchScaled[lane] = grains.pitchScaled[index];
+
+        firstSample = juce::jmin(firstSample, startSample[lane]);
+        lastSample = juce::jmax(lastSample, endSample[lane]);
+
+        grains.age[index] += (float) juce::jmax(0, endSample[lane] - startSample[lane]);
+        grains.startOffset[index] = 0;
+    }
+
+    const auto window = windowTable.data();
+    const auto historyData = history.data();
+    const auto output = outputAccumulator.data();
+    const auto windowSum = windowAccumulator.data();
+
+#if SCYCLONE_GRAIN_SSE2
+    const __m128 ageBase = _mm_loadu_ps(ageAtBlockStart);
+    const __m128 scale = _mm_loadu_ps(windowScale);
+    const __m128 delay = _mm_loadu_ps(startDelay);
+    const __m128 pitchFactor = _mm_loadu_ps(pitchScaled);
+    const __m128i start = _mm_loadu_si128(reinterpret_cast<const __m128i*>(startSample));
+    const __m128i end = _mm_loadu_si128(reinterpret_cast<const __m128i*>(endSample));
+    const __m128i writePosition = _mm_set1_epi32(historyWritePosition);
+    const __m128 lastWindowPosition = _mm_set1_ps((float) (windowTableSize - 1));
+
+    alignas(16) int windowIndex[grainsPerStep], readIndex[grainsPerStep];
+    alignas(16) float windowLow[grainsPerStep], windowHigh[grainsPerStep];
+    alignas(16) float historyLow[grainsPerStep], historyHigh[grainsPerStep];
+
+    // the grains of the group are the vector lanes, only the table and history reads are done lane by lane
+    for (int sample = firstSample; sample < lastSample; ++sample) {
+        const __m128i sampleIndex = _mm_set1_epi32(sample);
+        const __m128 samplePosition = _mm_cvtepi32_ps(sampleIndex);
+        const __m128 active = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpgt_epi32(start, sampleIndex),
+                                                                _mm_cmpgt_epi32(end, sampleIndex)));
+        const __m128 age = _mm_add_ps(ageBase, samplePosition);
+
+        // inactive lanes are clamped into the table, their gain is masked below
+        const __m128 windowPosition = _mm_max_ps(_mm_setzero_ps(), _mm_mul_ps(age, scale));
+        const __m128i windowTruncated = _mm_cvttps_epi32(_mm_min_ps(windowPosition, lastWindowPosition));
+        const __m128 windowFraction = _mm_sub_ps(windowPosition, _mm_cvtepi32_ps(windowTruncated));
+        _mm_store_si128(reinterpret_cast<__m128i*>(windowIndex), windowTruncated);
+
+        // read position relative to the start of this block, the delay shrinks as the grain is pitched up
+        const __m128 readPosition = _mm_sub_ps(samplePosition, _mm_sub_ps(delay, _mm_mul_ps(age, pitchFactor)));
+        __m128i readFloor = _mm_cvttps_epi32(readPosition);
+        readFloor = _mm_add_epi32(readFloor, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(readFloor), readPosition)));
+        const __m128 readFraction = _mm_sub_ps(readPosition, _mm_cvtepi32_ps(readFloor));
+        _mm_store_si128(reinterpret_cast<__m128i*>(readIndex), _mm_add_epi32(writePosition, readFloor));
+
+        for (int lane = 0; lane < grainsPerStep; ++lane) {
+            windowLow[lane] = window[windowIndex[lane]];
+            windowHigh[lane] = window[windowIndex[lane] + 1];
+            historyLow[lane] = historyData[readIndex[lane] & historyMask];
+            historyHigh[lane] = historyData[(readIndex[lane] + 1) & historyMask];
+        }
+
+        const __m128 low = _mm_load_ps(windowLow);
+        const __m128 gain = _mm_and_ps(active, _mm_add_ps(low, _mm_mul_ps(windowFraction, _mm_sub_ps(_mm_load_ps(windowHigh), low))));
+        const __m128 a = _mm_load_ps(historyLow);
+        const __m128 value = _mm_mul_ps(gain, _mm_add_ps(a, _mm_mul_ps(readFraction, _mm_sub_ps(_mm_load_ps(historyHigh), a))));
+
+        // both sums at once: [v0 + v2, g0 + g2, v1 + v3, g1 + g3], then the upper half onto the lower one
+        __m128 sums = _mm_add_ps(_mm_unpacklo_ps(value, gain), _mm_unpackhi_ps(value, gain));
+        sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+
+        output[sample] += _mm_cvtss_f32(sums);
+        windowSum[sample] += _mm_cvtss_f32(_mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 1, 1, 1)));
+    }
+#elif SCYCLONE_GRAIN_NEON
+    const float32x4_t ageBase = vld1q_f32(ageAtBlockStart);
+    const float32x4_t scale = vld1q_f32(windowScale);
+    const float32x4_t delay = vld1q_f32(startDelay);
+    const float32x4_t pitchFactor = vld1q_f32(pitchScaled);
+    const int32x4_t start = vld1q_s32(startSample);
+    const int32x4_t end = vld1q_s32(endSample);
+    const int32x4_t writePosition = vdupq_n_s32(historyWritePosition);
+    const float32x4_t lastWindowPosition = vdupq_n_f32((float) (windowTableSize - 1));
+
+    int windowIndex[grainsPerStep], readIndex[grainsPerStep];
+    float windowLow[grainsPerStep], windowHigh[grainsPerStep];
+    float historyLow[grainsPerStep], historyHigh[grainsPerStep];
+
+    // the grains of the group are the vector lanes, only the table and history reads are done lane by lane
+    for (int sample = firstSample; sample < lastSample; ++sample) {
+        const int32x4_t sampleIndex = vdupq_n_s32(sample);
+        const float32x4_t samplePosition = vcvtq_f32_s32(sampleIndex);
+        const uint32x4_t active = vandq_u32(vcleq_s32(start, sampleIndex), vcgtq_s32(end, sampleIndex));
+        const float32x4_t age = vaddq_f32(ageBase, samplePosition);
+
+        // inactive lanes are clamped into the table, their gain is masked below
+        const float32x4_t windowPosition = vmaxq_f32(vdupq_n_f32(0.f), vmulq_f32(age, scale));
+        const int32x4_t windowTruncated = vcvtq_s32_f32(vminq_f32(windowPosition, lastWindowPosition));
+        const float32x4_t windowFraction = vsubq_f32(windowPosition, vcvtq_f32_s32(windowTruncated));
+        vst1q_s32(windowIndex, windowTruncated);
+
+        // read position relative to the start of this block, the delay shrinks as the grain is pitched up
+        const float32x4_t readPosition = vsubq_f32(samplePosition, vmlsq_f32(delay, age, pitchFactor));
+        int32x4_t readFloor = vcvtq_s32_f32(readPosition);
+        readFloor = vaddq_s32(readFloor, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(readFloor), readPosition)));
+        const float32x4_t readFraction = vsubq_f32(readPosition, vcvtq_f32_s32(readFloor));
+        vst1q_s32(readIndex, vaddq_s32(writePosition, readFloor));
+
+        for (int lane = 0; lane < grainsPerStep; ++lane) {
+            windowLow[lane] = window[windowIndex[lane]];
+            windowHigh[lane] = window[windowIndex[lane] + 1];
+            historyLow[lane] = historyData[readIndex[lane] & historyMask];
+            historyHigh[lane] = historyData[(readIndex[lane] + 1) & historyMask];
+        }
+
+        const float32x4_t low = vld1q_f32(windowLow);
+        const float32x4_t interpolated = vmlaq_f32(low, windowFraction, vsubq_f32(vld1q_f32(windowHigh), low));
+        const float32x4_t gain = vreinterpretq_f32_u32(vandq_u32(active, vreinterpretq_u32_f32(interpolated)));
+        const float32x4_t a = vld1q_f32(historyLow);
+        const float32x4_t value = vmulq_f32(gain, vmlaq_f32(a, readFraction, vsubq_f32(vld1q_f32(historyHigh), a)));
+
+        // two pairwise adds leave [v0 + v1 + v2 + v3, g0 + g1 + g2 + g3]
+        const float32x2_t sums = vpadd_f32(vpadd_f32(vget_low_f32(value), vget_high_f32(value)),
+                                           vpadd_f32(vget_low_f32(gain), vget_high_f32(gain)));
+
+        output[sample] += vget_lane_f32(sums, 0);
+        windowSum[sample] += vget_lane_f32(sums, 1);
+    }
+#else
+    for (int sample = firstSample; sample < lastSample; ++sample) {
+        float outputSum = 0.f, gainSum = 0.f;
+
+        for (int lane = 0; lane < grainsPerStep; ++lane) {
+            const float active = (float) ((sample >= startSample[lane]) & (sample < endSample[lane]));
+            const float age = ageAtBlockStart[lane] + (float) sample;
+
+            // inactive lanes are clamped into the table, their gain is zeroed below
+            const float windowPosition = juce::jmax(0.f, age * windowScale[lane]);
+            const int windowIndex = (int) juce::jmin(windowPosition, (float) (windowTableSize - 1));
+            const float windowFraction = windowPosition - (float) windowIndex;
+            const float gain = active * (window[windowIndex] + windowFraction * (window[windowIndex + 1] - window[windowIndex]));
+
+            // read position relative to the start of this block, the delay shrinks as the grain is pitched up
+            const float readPosition = (float) sample - (startDelay[lane] - age * pitchScaled[lane]);
+            const float readFloor = std::floor(readPosition);
+            const int readIndex = historyWritePosition + (int) readFloor;
+            const float readFraction = readPosition - readFloor;
+            const float a = historyData[readIndex & historyMask];
+            const float b = historyData[(readIndex + 1) & historyMask];
+
+            outputSum += gain * (a + readFraction * (b - a));
+            gainSum += gain;
+        }
+
+        output[sample] += outputSum;
+        windowSum[sample] += gainSum;
+    }
+#endif
+}
+
+void GranularEngine::removeFinishedGrains() {
+    for (int grain = 0; grain < numActiveGrains;) {
+        const auto index = (size_t) grain;
+        if (grains.age[index] < grains.size[index]) {
+            ++grain;
+            continue;
+        }
+
+        const auto last = (size_t) --numActiveGrains;
+        grains.age[index] = grains.age[last];
+        grains.size[index] = grains.size[last];
+        grains.inverseSize[index] = grains.inverseSize[last];
+        grains.startDelay[index] = grains.startDelay[last];
+        grains.pitchScaled[index] = grains.pitchScaled[last];
+        grains.startOffset[index] = grains.startOffset[last];
+    }
+}
+
+void GranularEngine::normalise(float *data, int numSamples) {
+    const auto output = outputAccumulator.data();
+    const auto windowSum = windowAccumulator.data();
+
+    // windowSum^-exponent as exp2(-exponent * log2(windowSum)) over the whole block
+    juce::FloatVectorOperations::max(windowSum, windowSum, 1.f, numSamples);
+    utils::fastLog2(windowSum, windowSum, numSamples);
+    juce::FloatVectorOperations::multiply(windowSum, -normalisationExponent, numSamples);
+    utils::fastExp2(windowSum, windowSum, numSamples);
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+        outputGain += (1.f - outputGain) * gainSmoothing;
+        data[sample] = output[sample] * windowSum[sample] * outputGain;
+    }
+}
+
+float GranularEngine::msToSamples(float ms) const {
+    return (float) (ms * 0.001 * sampleRate);
+}
+
+size_t GranularEngine::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(grains.age) + MemoryUsage::getSizeInBytes(grains.size)
+           + MemoryUsage::getSizeInBytes(grains.inverseSize) + MemoryUsage::getSizeInBytes(grains.startDelay)
+           + MemoryUsage::getSizeInBytes(grains.pitchScaled) + MemoryUsage::getSizeInBytes(grains.startOffset)
+           + MemoryUsage::getSizeInBytes(history) + MemoryUsage::getSizeInBytes(windowTable)
+           + MemoryUsage::getSizeInBytes(outputAccumulator) + MemoryUsage::getSizeInBytes(windowAccumulator);
+}
@@ -0,0 +1,84 @@
+#ifndef VAESYNTH_GRANULARENGINE_H
+#define VAESYNTH_GRANULARENGINE_H
+
+#include <JuceHeader.h>
+
+/*  Mono grain delay with the parameters of the former RNBO patch (position, size, pitch, interval).
+ *
+ *  Every interval a grain is started that reads the input history with a Hann window. Its start delay is a random
+ *  fraction of the position plus the headroom the grain needs when it is pitched up. Active grains are kept in a
+ *  compact structure-of-arrays list and rendered over the whole block into an accumulation buffer, four grains per
+ *  step in the lanes of an SSE2 or NEON vector, so the cost follows the number of grains actually playing. The sum is
+ *  normalised by the total window weight.
+ */
+class GranularEngine {
+public:
+    explicit GranularEngine(int maxGrains = defaultMaxGrains);
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    void release();
+    void process(float* data, int numSamples);
+
+    // values are limited to the ranges of the original patch
+    void setPosition(float newPositionInMs);
+    void setGrainSize(float newGrainSizeInMs);
+    void setPitch(float newPitchInSemitones);
+    void setInterval(float newIntervalInMs);
+
+    int getNumActiveGrains() const;
+    size_t getSizeInBytes() const;
+
+    static constexpr int defaultMaxGrains = 100;
+
+private:
+    void writeHistory(const float* data, int numSamples);
+    void spawnGrains(int numSamples);
+    void startGrain(int offset);
+    void renderGrains(int firstGrain, int numSamples);
+    void removeFinishedGrains();
+    void normalise(float* data, int numSamples);
+    float msToSamples(float ms) const;
+
+private:
+    // grain state, one entry per active grain
+    struct Grains {
+        std::vector<float> age;
+        std::vector<float> size;
+        std::vector<float> inverseSize;
+        std::vector<float> startDelay;
+        std::vector<float> pitchScaled;
+        std::vector<int> startOffset;
+    } grains;
+
+    int numActiveGrains = 0;
+    const int maxGrains;
+
+    std::vector<float> history;
+    int historyMask = 0;
+    int historyWritePosition = 0;
+
+    std::vector<float> windowTable;
+    std::vector<float> outputAccumulator;
+    std::vector<float> windowAccumulator;
+
+    std::atomic<float> position {2.f};
+    std::atomic<float> grainSize {100.f};
+    std::atomic<float> pitch {0.f};
+    std::atomic<float> interval {50.f};
+
+    float intervalCounter = 0.f;
+    float outputGain = 0.f;
+    double sampleRate = 48000.;
+    juce::Random random;
+
+    static constexpr int windowTableSize = 1024;
+    static constexpr int grainsPerStep = 4;
+    static constexpr double historyLengthInSeconds = 2.;
+    static constexpr float gainSmoothing = 0.001f;
+    static constexpr float normalisationExponent = 0.3f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GranularEngine)
+};
+
+#endif //VAESYNTH_GRANULARENGINE_H
@@ -0,0 +1,52 @@
+#include "NetworkMixer.h"
+
+NetworkMixer::NetworkMixer() {
+    for (auto& gain : targetGains)
+        gain.store(1.f / (float) PluginParameters::NUM_NETWORKS);
+}
+
+void NetworkMixer::prepare(const juce::dsp::ProcessSpec &spec) {
+    for (size_t i = 0; i < smoothedGains.size(); ++i) {
+        smoothedGains[i].reset(spec.sampleRate, rampLengthInSeconds);
+        smoothedGains[i].setCurrentAndTargetValue(targetGains[i].load());
+    }
+}
+
+void NetworkMixer::setNetworkGain(int networkIndex, float gain) {
+    targetGains[(size_t) networkIndex].store(gain);
+}
+
+void NetworkMixer::setFade(float fade) {
+    static_assert (PluginParameters::NUM_NETWORKS == 2, "the fade parameter has no meaning for more than two networks");
+    // the fade parameter crossfades between the first two networks: 1 = network 1 only, 0 = network 2 only
+    setNetworkGain(0, fade);
+    setNetworkGain(1, 1.f - fade);
+}
+
+template <typename SampleType>
+void NetworkMixer::process(const std::array<juce::AudioBuffer<SampleType>*, PluginParameters::NUM_NETWORKS> &networkBuffers,
+                           juce::AudioBuffer<SampleType> &outputBuffer) {
+    const int numSamples = outputBuffer.getNumSamples();
+
+    for (size_t i = 0; i < networkBuffers.size(); ++i) {
+        auto& gain = smoothedGains[i];
+        gain.setTargetValue(targetGains[i].load());
+
+        const auto startGain = (SampleType) gain.getCurrentValue();
+        gain.skip(numSamples);
+        const auto endGain = (SampleType) gain.getCurrentValue();
+
+        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel) {
+            auto networkData = networkBuffers[i]->getReadPointer(channel);
+            if (i > 0)
+                outputBuffer.addFromWithRamp(channel, 0, networkData, numSamples, startGain, endGain);
+            else if (networkData == outputBuffer.getReadPointer(channel))
+                outputBuffer.applyGainRamp(channel, 0, numSamples, startGain, endGain);
+            else
+                outputBuffer.copyFromWithRamp(channel, 0, networkData, numSamples, startGain, endGain);
+        }
+    }
+}
+
+template void NetworkMixer::process<float>(const std::array<juce::AudioBuffer<float>*, PluginParameters::NUM_NETWORKS>&, juce::AudioBuffer<float>&);
+template void NetworkMixer::process<double>(const std::array<juce::AudioBuffer<double>*, PluginParameters::NUM_NETWORKS>&, juce::AudioBuffer<double>&);
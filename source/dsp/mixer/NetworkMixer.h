@@ -0,0 +1,30 @@
+#ifndef VAESYNTH_NETWORKMIXER_H
+#define VAESYNTH_NETWORKMIXER_H
+
+#include <JuceHeader.h>
+#include "../../PluginParameters.h"
+
+/*  Blends the outputs of all network slots into one buffer. Every network has its own smoothed gain, the gains
+ *  can be set from any thread and are picked up at the start of the next block. The output buffer may be the
+ *  first network's buffer, which is then scaled in place.
+ */
+class NetworkMixer {
+public:
+    NetworkMixer();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void setNetworkGain(int networkIndex, float gain);
+    void setFade(float fade);
+
+    template <typename SampleType>
+    void process(const std::array<juce::AudioBuffer<SampleType>*, PluginParameters::NUM_NETWORKS>& networkBuffers,
+                 juce::AudioBuffer<SampleType>& outputBuffer);
+
+private:
+    std::array<std::atomic<float>, PluginParameters::NUM_NETWORKS> targetGains;
+    std::array<juce::SmoothedValue<float>, PluginParameters::NUM_NETWORKS> smoothedGains;
+
+    static constexpr double rampLengthInSeconds = 0.05;
+};
+
+#endif //VAESYNTH_NETWORKMIXER_H
@@ -0,0 +1,137 @@
+#include "OutputStage.h"
+#include "../utils/MemoryUsage.h"
+
+template <typename SampleType>
+void OutputStage<SampleType>::prepare(const juce::dsp::ProcessSpec &spec) {
+    maxBlockSize = (int) spec.maximumBlockSize;
+
+    const int delaySize = juce::nextPowerOfTwo(maxWetLatencyInSamples + maxBlockSize);
+    dryDelayLines.assign(juce::jmax((size_t) 1, (size_t) spec.numChannels), std::vector<SampleType>((size_t) delaySize, 0));
+    delayMask = delaySize - 1;
+
+    compressorWet.reset(spec.sampleRate, rampLengthInSeconds);
+    outputGain.reset(spec.sampleRate, rampLengthInSeconds);
+    wetProportion.reset(spec.sampleRate, rampLengthInSeconds);
+
+    reset();
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::reset() {
+    for (auto& delayLine : dryDelayLines)
+        std::fill(delayLine.begin(), delayLine.end(), (SampleType) 0);
+    dryWritePosition = 0;
+    dryBlockStart = 0;
+
+    compressorWet.setCurrentAndTargetValue(compressorWet.getTargetValue());
+    outputGain.setCurrentAndTargetValue(outputGain.getTargetValue());
+    wetProportion.setCurrentAndTargetValue(wetProportion.getTargetValue());
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::release() {
+    dryDelayLines = {};
+    delayMask = 0;
+    dryWritePosition = 0;
+    dryBlockStart = 0;
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::setParameters(const ParameterSnapshot &snapshot) {
+    compressorWet.setTargetValue(juce::jlimit(0.f, 1.f, snapshot.compDryWet));
+    outputGain.setTargetValue(juce::Decibels::decibelsToGain(snapshot.outputGain));
+    wetProportion.setTargetValue(juce::jlimit(0.f, 1.f, snapshot.dryWet));
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::setWetLatency(int numberOfSamples) {
+    wetLatency = juce::jlimit(0, maxWetLatencyInSamples, numberOfSamples);
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::pushDrySamples(const juce::AudioBuffer<SampleType> &dryBuffer) {
+    const int numSamples = dryBuffer.getNumSamples();
+    const int numChannels = juce::jmin(dryBuffer.getNumChannels(), (int) dryDelayLines.size());
+    jassert (numSamples <= maxBlockSize);
+
+    const int delaySize = delayMask + 1;
+    const int firstPart = juce::jmin(numSamples, delaySize - dryWritePosition);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto source = dryBuffer.getReadPointer(channel);
+        auto delayLine = dryDelayLines[(size_t) channel].data();
+        std::copy(source, source + firstPart, delayLine + dryWritePosition);
+        std::copy(source + firstPart, source + numSamples, delayLine);
+    }
+
+    dryBlockStart = dryWritePosition;
+    dryWritePosition = (dryWritePosition + numSamples) & delayMask;
+}
+
+template <typename SampleType>
+bool OutputStage<SampleType>::needsCompressorDry() const {
+    return compressorWet.isSmoothing() || compressorWet.getTargetValue() < 1.f;
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::process(const SampleType *compressorDry, const SampleType *compressed, juce::AudioBuffer<SampleType> &output) {
+    const int numSamples = output.getNumSamples();
+    const int numChannels = juce::jmin(output.getNumChannels(), (int) dryDelayLines.size());
+    if (numChannels == 0) return;
+
+    compressorWetRamp = nextRamp(compressorWet, numSamples);
+    outputGainRamp = nextRamp(outputGain, numSamples);
+    wetProportionRamp = nextRamp(wetProportion, numSamples);
+
+    // mono and stereo are the only layouts, a mono output writes its channel twice
+    auto left = output.getWritePointer(0);
+    auto right = output.getWritePointer(numChannels - 1);
+    auto& dryLeft = dryDelayLines.front();
+    auto& dryRight = dryDelayLines[(size_t) numChannels - 1];
+
+    // the delayed dry block wraps around the end of the delay line at most once
+    const int readStart = (dryBlockStart - wetLatency) & delayMask;
+    const int firstPart = juce::jmin(numSamples, delayMask + 1 - readStart);
+
+    processSegment(compressorDry, compressed, dryLeft.data() + readStart, dryRight.data() + readStart,
+                   left, right, 0, firstPart);
+    processSegment(compressorDry, compressed, dryLeft.data(), dryRight.data(),
+                   left, right, firstPart, numSamples - firstPart);
+}
+
+template <typename SampleType>
+typename OutputStage<SampleType>::Ramp OutputStage<SampleType>::nextRamp(juce::SmoothedValue<float> &value, int numSamples) {
+    Ramp ramp;
+    ramp.start = (SampleType) value.getCurrentValue();
+    value.skip(numSamples);
+    ramp.step = numSamples > 0 ? ((SampleType) value.getCurrentValue() - ramp.start) / (SampleType) numSamples : 0;
+    return ramp;
+}
+
+template <typename SampleType>
+void OutputStage<SampleType>::processSegment(const SampleType *compressorDry, const SampleType *compressed, const SampleType *dryLeft,
+                                 const SampleType *dryRight, SampleType *left, SampleType *right, int offset, int numSamples) const {
+    // the dry pointers point to the start of the segment, everything else to the start of the block
+    for (int i = 0; i < numSamples; ++i) {
+        const int sample = offset + i;
+        const SampleType compWet = compressorWetRamp.at(sample);
+        const SampleType wet = wetProportionRamp.at(sample);
+        const SampleType wetGain = outputGainRamp.at(sample) * wet;
+        const SampleType dryGain = 1 - wet;
+
+        const SampleType mixed = compressorDry[sample] + compWet * (compressed[sample] - compressorDry[sample]);
+        const SampleType wetSample = mixed * wetGain;
+        left[sample] = dryLeft[i] * dryGain + wetSample;
+        right[sample] = dryRight[i] * dryGain + wetSample;
+    }
+}
+
+template <typename SampleType>
+size_t OutputStage<SampleType>::getSizeInBytes() const {
+    size_t total = MemoryUsage::getSizeInBytes(dryDelayLines);
+    for (const auto& line : dryDelayLines)
+        total += MemoryUsage::getSizeInBytes(line);
+    return total;
+}
+
+template class OutputStage<float>;
+template class OutputStage<double>;
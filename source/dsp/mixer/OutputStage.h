@@ -0,0 +1,57 @@
+#ifndef VAESYNTH_OUTPUTSTAGE_H
+#define VAESYNTH_OUTPUTSTAGE_H
+
+#include <JuceHeader.h>
+#include "../../ParameterSnapshot.h"
+
+/*  Everything behind the compressor in one sweep over the mono signal: compressor dry/wet, output gain and the
+ *  global dry/wet, written straight into every output channel. The dry input is kept per channel in a delay line
+ *  that matches the wet latency, as juce::dsp::DryWetMixer did. All gains are smoothed and ramp linearly over the
+ *  block.
+ */
+template <typename SampleType>
+class OutputStage {
+public:
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    void release();
+    void setParameters(const ParameterSnapshot& snapshot);
+    void setWetLatency(int numberOfSamples);
+
+    void pushDrySamples(const juce::AudioBuffer<SampleType>& dryBuffer);
+    // while the compressor is fully wet its dry signal is not used, and the compressed signal can be passed instead
+    bool needsCompressorDry() const;
+    void process(const SampleType* compressorDry, const SampleType* compressed, juce::AudioBuffer<SampleType>& output);
+
+    size_t getSizeInBytes() const;
+
+private:
+    struct Ramp {
+        SampleType start = 0;
+        SampleType step = 0;
+
+        SampleType at(int sample) const { return start + step * (SampleType) (sample + 1); }
+    };
+
+    static Ramp nextRamp(juce::SmoothedValue<float>& value, int numSamples);
+    void processSegment(const SampleType* compressorDry, const SampleType* compressed, const SampleType* dryLeft,
+                        const SampleType* dryRight, SampleType* left, SampleType* right, int offset, int numSamples) const;
+
+private:
+    std::vector<std::vector<SampleType>> dryDelayLines;
+    int delayMask = 0;
+    int dryWritePosition = 0;
+    int dryBlockStart = 0;
+    int wetLatency = 0;
+    int maxBlockSize = 0;
+
+    juce::SmoothedValue<float> compressorWet {1.f};
+    juce::SmoothedValue<float> outputGain {1.f};
+    juce::SmoothedValue<float> wetProportion {1.f};
+    Ramp compressorWetRamp, outputGainRamp, wetProportionRamp;
+
+    static constexpr int maxWetLatencyInSamples = 48000;
+    static constexpr double rampLengthInSeconds = 0.05;
+};
+
+#endif //VAESYNTH_OUTPUTSTAGE_H
@@ -0,0 +1,51 @@
+#include "TapMixer.h"
+
+void TapMixer::prepare(const juce::dsp::ProcessSpec &spec) {
+    wetProportion.reset(spec.sampleRate, rampLengthInSeconds);
+}
+
+void TapMixer::setWetProportion(float newWetProportion) {
+    wetProportion.setTargetValue(juce::jlimit(0.f, 1.f, newWetProportion));
+}
+
+bool TapMixer::needsDrySignal() const {
+    return wetProportion.isSmoothing() || wetProportion.getTargetValue() < 1.f;
+}
+
+template <typename SampleType>
+void TapMixer::mix(const juce::dsp::AudioBlock<SampleType> &dryBlock, juce::AudioBuffer<SampleType> &wetBuffer) {
+    const int numSamples = wetBuffer.getNumSamples();
+    const int numChannels = juce::jmin(wetBuffer.getNumChannels(), (int) dryBlock.getNumChannels());
+    jassert ((int) dryBlock.getNumSamples() >= numSamples);
+
+    if (!wetProportion.isSmoothing()) {
+        const auto wet = (SampleType) wetProportion.getTargetValue();
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto wetData = wetBuffer.getWritePointer(channel);
+            juce::FloatVectorOperations::multiply(wetData, wet, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(wetData, dryBlock.getChannelPointer((size_t) channel), (SampleType) 1 - wet, numSamples);
+        }
+        return;
+    }
+
+    // the linear ramp is the same for every channel, so it is interpolated instead of stepping the smoother per channel
+    const float startWet = wetProportion.getCurrentValue();
+    wetProportion.skip(numSamples);
+    const float increment = (wetProportion.getCurrentValue() - startWet) / (float) numSamples;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto wetData = wetBuffer.getWritePointer(channel);
+        auto dryData = dryBlock.getChannelPointer((size_t) channel);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            const auto wet = (SampleType) (startWet + increment * (float) (sample + 1));
+            wetData[sample] = dryData[sample] + wet * (wetData[sample] - dryData[sample]);
+        }
+    }
+}
+
+void TapMixer::skip(int numSamples) {
+    wetProportion.skip(numSamples);
+}
+
+template void TapMixer::mix<float>(const juce::dsp::AudioBlock<float>&, juce::AudioBuffer<float>&);
+template void TapMixer::mix<double>(const juce::dsp::AudioBlock<double>&, juce::AudioBuffer<double>&);
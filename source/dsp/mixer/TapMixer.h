@@ -0,0 +1,26 @@
+#ifndef VAESYNTH_TAPMIXER_H
+#define VAESYNTH_TAPMIXER_H
+
+#include <JuceHeader.h>
+
+/*  Linear dry/wet blend that mixes a dry tap into the wet signal in place. Unlike juce::dsp::DryWetMixer it keeps no
+ *  dry buffer of its own, and it tells the caller when the dry signal is not needed at all (fully wet and not
+ *  ramping), so the tap does not have to be filled.
+ */
+class TapMixer {
+public:
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void setWetProportion(float newWetProportion);
+
+    bool needsDrySignal() const;
+    template <typename SampleType>
+    void mix(const juce::dsp::AudioBlock<SampleType>& dryBlock, juce::AudioBuffer<SampleType>& wetBuffer);
+    void skip(int numSamples);
+
+private:
+    juce::SmoothedValue<float> wetProportion {1.f};
+
+    static constexpr double rampLengthInSeconds = 0.05;
+};
+
+#endif //VAESYNTH_TAPMIXER_H
@@ -0,0 +1,188 @@
+#include "NetworkSlot.h"
+
+NetworkSlot::NetworkSlot(juce::AudioProcessorValueTreeState &apvts, int no, RaveModel raveModel, EventLog& log, StageProfiler& profiler) :
+        parameters(apvts),
+        eventLog(log),
+        stageProfiler(profiler),
+        number(no),
+        processorTransientSplitter(apvts, no),
+        iirCutoffFilters(apvts, no),
+        onnxProcessor(apvts, no, raveModel, log),
+        grainDelay(no)
+{
+    onnxProcessor.onOnnxModelLoad = [this] (bool initLoading, juce::String modelName) {
+        if (onModelLoad) onModelLoad(initLoading, modelName);
+    };
+}
+
+void NetworkSlot::prepare(const juce::dsp::ProcessSpec &monoSpec, int hostBlockSize, juce::AudioProcessor::ProcessingPrecision precision) {
+    // the inference is reset by its own prepare, so an active branch starts with the warm-up
+    branchState = active ? BranchState::warmingUp : BranchState::idle;
+    branchGain.reset(monoSpec.sampleRate, branchFadeTimeInSeconds);
+    branchGain.setCurrentAndTargetValue(0.f);
+
+    grainMixer.prepare(monoSpec);
+    onnxProcessor.prepare(monoSpec, hostBlockSize);
+    iirCutoffFilters.prepare(precision, monoSpec);
+    processorTransientSplitter.prepare(monoSpec, precision);
+    grainDelay.prepare(monoSpec);
+    latencyCompensation.prepare(precision, monoSpec);
+}
+
+void NetworkSlot::release() {
+    onnxProcessor.release();
+    grainDelay.release();
+    latencyCompensation.forEach([] (auto& delay) { delay.release(); });
+}
+
+void NetworkSlot::addMemoryUsage(MemoryUsage &usage) const {
+    usage.add("transient splitter", processorTransientSplitter.getSizeInBytes());
+    usage.add("cutoff filter", iirCutoffFilters.getSizeInBytes());
+    onnxProcessor.addMemoryUsage(usage.addChild("inference"));
+    usage.add("level analyser", levelAnalyser.getSizeInBytes());
+    usage.add("grain delay", grainDelay.getSizeInBytes());
+    usage.add("latency compensation", latencyCompensation.getSizeInBytes());
+}
+
+template <typename SampleType>
+PreProcessingLanes::Network<SampleType> NetworkSlot::getPreProcessingLane() {
+    return {&processorTransientSplitter.getTransientSplitter<SampleType>(), &iirCutoffFilters.get<SampleType>(), isProcessing()};
+}
+
+template <typename SampleType>
+void NetworkSlot::processNetwork(juce::AudioBuffer<SampleType> &bus, RoutingGraph<SampleType> &routingGraph) {
+    if (branchState == BranchState::idle) {
+        levelAnalyser.processBlock(bus);
+        return;
+    }
+
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::inference);
+        onnxProcessor.processBlock(bus);
+    }
+
+    if (branchState == BranchState::warmingUp) {
+        if (onnxProcessor.isWarmingUp()) {
+            bus.clear();
+            levelAnalyser.processBlock(bus);
+            return;
+        }
+        branchState = BranchState::running;
+        branchGain.setTargetValue(1.f);
+    }
+
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::levelAnalyser);
+        const auto repairs = modelOutputSanitizer.process(bus);
+        if (repairs.startsNonFiniteEpisode)
+            eventLog.log(DiagnosticEvent::Type::samplesRepaired, number, repairs.nonFiniteSamples, repairs.denormalSamples, "model output");
+        levelAnalyser.processBlock(bus);
+    }
+
+    {
+        SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::grainDelay);
+        // a muted grain delay passes the signal through, so the dry tap is only needed while it runs
+        if (grainDelay.isActive() && grainMixer.needsDrySignal()) {
+            const int grainDryTap = RoutingGraph<SampleType>::getGrainDryTap(number - 1);
+            auto dryBlock = routingGraph.acquireTap(grainDryTap, bus);
+            grainDelay.processBlock(bus);
+            grainMixer.mix(dryBlock, bus);
+            routingGraph.releaseTap(grainDryTap);
+        } else {
+            grainDelay.processBlock(bus);
+            grainMixer.skip(bus.getNumSamples());
+        }
+    }
+
+    SCYCLONE_PROFILE_STAGE(stageProfiler, StageProfiler::branchOutput);
+    latencyCompensation.get<SampleType>().process(bus.getWritePointer(0), bus.getNumSamples());
+    processBranchGain(bus);
+}
+
+template <typename SampleType>
+void NetworkSlot::processBranchGain(juce::AudioBuffer<SampleType> &bus) {
+    const int numSamples = bus.getNumSamples();
+    const float startGain = branchGain.getCurrentValue();
+    branchGain.skip(numSamples);
+    const float endGain = branchGain.getCurrentValue();
+
+    if (startGain != 1.f || endGain != 1.f)
+        bus.applyGainRamp(0, 0, numSamples, (SampleType) startGain, (SampleType) endGain);
+
+    if (!active && endGain == 0.f)
+        branchState = BranchState::idle;
+}
+
+void NetworkSlot::updateBranchState() {
+    switch (branchState) {
+        case BranchState::idle:
+            // switched on again, the model needs a fresh warm-up before the branch fades in
+            if (active && onnxProcessor.restart()) {
+                latencyCompensation.forEach([] (auto& delay) { delay.reset(); });
+                branchState = BranchState::warmingUp;
+            }
+            break;
+        case BranchState::warmingUp:
+            if (!active)
+                branchState = BranchState::idle;
+            break;
+        case BranchState::running:
+            branchGain.setTargetValue(active ? 1.f : 0.f);
+            break;
+    }
+}
+
+void NetworkSlot::setParameters(const NetworkParameterSnapshot &snapshot) {
+    active = snapshot.onOff;
+    updateBranchState();
+
+    processorTransientSplitter.setParameters(snapshot);
+    iirCutoffFilters.forEach([&snapshot] (auto& filter) {
+        filter.updateFilterParams(snapshot.filter);
+        filter.setMuted(!snapshot.onOff);
+    });
+    grainDelay.setParameters(snapshot);
+    grainMixer.setWetProportion(snapshot.grainMix);
+}
+
+void NetworkSlot::parameterChanged(const juce::String &parameterID, float newValue) {
+    // the model selection loads a new session, so it stays on the listener thread
+    onnxProcessor.parameterChanged(parameterID, newValue);
+}
+
+void NetworkSlot::loadExternalModel(const juce::File &path) {
+    onnxProcessor.loadExternalModel(path);
+}
+
+int NetworkSlot::getNumber() const {
+    return number;
+}
+
+int NetworkSlot::getLatency() const {
+    return onnxProcessor.getLatency();
+}
+
+void NetworkSlot::setLatencyCompensation(int numSamples) {
+    latencyCompensation.forEach([numSamples] (auto& delay) { delay.setDelay(numSamples); });
+}
+
+bool NetworkSlot::isActive() const {
+    return active;
+}
+
+bool NetworkSlot::isProcessing() const {
+    return branchState != BranchState::idle;
+}
+
+LevelAnalyser &NetworkSlot::getLevelAnalyser() {
+    return levelAnalyser;
+}
+
+const Sanitizer &NetworkSlot::getModelOutputSanitizer() const {
+    return modelOutputSanitizer;
+}
+
+template PreProcessingLanes::Network<float> NetworkSlot::getPreProcessingLane<float>();
+template PreProcessingLanes::Network<double> NetworkSlot::getPreProcessingLane<double>();
+template void NetworkSlot::processNetwork<float>(juce::AudioBuffer<float>&, RoutingGraph<float>&);
+template void NetworkSlot::processNetwork<double>(juce::AudioBuffer<double>&, RoutingGraph<double>&);
@@ -0,0 +1,94 @@
+#ifndef VAESYNTH_NETWORKSLOT_H
+#define VAESYNTH_NETWORKSLOT_H
+
+#include <JuceHeader.h>
+#include "../../PluginParameters.h"
+#include "../../ParameterSnapshot.h"
+#include "../transientSplitter/ProcessorTransientSplitter.h"
+#include "../Filter/IIRCutoffFilter.h"
+#include "../onnx/OnnxProcessor.h"
+#include "../analyser/LevelAnalyser.h"
+#include "../grainDelay/GrainDelay.h"
+#include "../mixer/TapMixer.h"
+#include "../routing/RoutingGraph.h"
+#include "../utils/Sanitizer.h"
+#include "../utils/CompensationDelay.h"
+#include "../utils/StageProfiler.h"
+#include "../utils/PerPrecision.h"
+#include "PreProcessingLanes.h"
+
+/*  One network branch: transient splitter and cutoff filter in front of the model, level analyser and grain delay
+ *  behind it. The model inference itself runs on the shared InferencePool. The slot owns no audio buffers, it
+ *  processes the network bus the RoutingGraph hands it in place.
+ *
+ *  A switched-off branch fades out and then goes idle: nothing is sent to the inference and the DSP state is
+ *  frozen until it is switched on again. It then warms the model up like after a restart and fades in.
+ */
+class NetworkSlot {
+public:
+    NetworkSlot(juce::AudioProcessorValueTreeState& apvts, int no, RaveModel raveModel, EventLog& log, StageProfiler& profiler);
+
+    // monoSpec carries the sub-block size the stages run at, the latency follows the host block size
+    void prepare(const juce::dsp::ProcessSpec& monoSpec, int hostBlockSize, juce::AudioProcessor::ProcessingPrecision precision);
+    // frees the model session and the long buffers while the host has the plugin suspended
+    void release();
+    // the transient splitter and cutoff filter run in the shared PreProcessingLanes pass
+    template <typename SampleType>
+    PreProcessingLanes::Network<SampleType> getPreProcessingLane();
+    template <typename SampleType>
+    void processNetwork(juce::AudioBuffer<SampleType>& bus, RoutingGraph<SampleType>& routingGraph);
+    void setParameters(const NetworkParameterSnapshot& snapshot);
+    void parameterChanged(const juce::String& parameterID, float newValue);
+
+    void loadExternalModel(const juce::File& path);
+
+    int getNumber() const;
+    int getLatency() const;
+    // delays the branch output so it lines up with a slower branch
+    void setLatencyCompensation(int numSamples);
+    bool isActive() const;
+    bool isProcessing() const;
+
+    LevelAnalyser& getLevelAnalyser();
+
+    const Sanitizer& getModelOutputSanitizer() const;
+
+    void addMemoryUsage(MemoryUsage& usage) const;
+
+    std::function<void(bool initLoading, juce::String modelName)> onModelLoad;
+
+private:
+    void updateBranchState();
+    template <typename SampleType>
+    void processBranchGain(juce::AudioBuffer<SampleType>& bus);
+
+private:
+    enum class BranchState {
+        idle,
+        warmingUp,
+        running
+    };
+
+    juce::AudioProcessorValueTreeState& parameters;
+    EventLog& eventLog;
+    [[maybe_unused]] StageProfiler& stageProfiler;
+    int number;
+    bool active = false;
+    BranchState branchState = BranchState::warmingUp;
+    juce::SmoothedValue<float> branchGain;
+
+    ProcessorTransientSplitter processorTransientSplitter;
+    PerPrecision<IIRCutoffFilter> iirCutoffFilters;
+    OnnxProcessor onnxProcessor;
+    LevelAnalyser levelAnalyser;
+    GrainDelay grainDelay;
+    TapMixer grainMixer;
+    Sanitizer modelOutputSanitizer;
+    PerPrecision<CompensationDelay> latencyCompensation;
+
+    static constexpr double branchFadeTimeInSeconds = 0.02;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NetworkSlot)
+};
+
+#endif //VAESYNTH_NETWORKSLOT_H
@@ -0,0 +1,55 @@
+#include "PreProcessingLanes.h"
+
+void PreProcessingLanes::prepare(int maxBlockSize) {
+    laneBuffer.prepare(maxBlockSize);
+}
+
+void PreProcessingLanes::process(const Networks<float> &networks, const juce::AudioBuffer<float> &input, const Buses<float> &buses) {
+    static_assert (PluginParameters::NUM_NETWORKS <= LaneBuffer::maxLanes, "every network needs its own lane");
+
+    std::array<TransientSplitter<float>*, PluginParameters::NUM_NETWORKS> splitters {};
+    std::array<IIRCutoffFilter<float>*, PluginParameters::NUM_NETWORKS> filters {};
+    std::array<size_t, PluginParameters::NUM_NETWORKS> laneNetworks {};
+    int numLanes = 0;
+    for (size_t i = 0; i < networks.size(); ++i) {
+        if (!networks[i].processing) continue;
+        splitters[(size_t) numLanes] = networks[i].transientSplitter;
+        filters[(size_t) numLanes] = networks[i].cutoffFilter;
+        laneNetworks[(size_t) numLanes++] = i;
+    }
+
+    if (numLanes > 0) {
+        laneBuffer.broadcast(input.getReadPointer(0), input.getNumSamples());
+        TransientSplitter<float>::processLanes(splitters.data(), numLanes, laneBuffer);
+        IIRCutoffFilter<float>::processLanes(filters.data(), numLanes, laneBuffer);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            laneBuffer.copyLaneTo(lane, buses[laneNetworks[(size_t) lane]]->getWritePointer(0));
+    }
+
+    // the input can be the bus of an idle network, so it is only cleared once every lane has read it
+    for (size_t i = 0; i < networks.size(); ++i)
+        if (!networks[i].processing)
+            buses[i]->clear();
+}
+
+void PreProcessingLanes::process(const Networks<double> &networks, const juce::AudioBuffer<double> &input, const Buses<double> &buses) {
+    // every processing bus gets the input before the first one is processed in place, which may be the input itself
+    for (size_t i = 0; i < networks.size(); ++i)
+        if (networks[i].processing && buses[i] != &input)
+            buses[i]->copyFrom(0, 0, input, 0, 0, input.getNumSamples());
+
+    for (size_t i = 0; i < networks.size(); ++i) {
+        if (!networks[i].processing) continue;
+        networks[i].transientSplitter->processBlock(*buses[i]);
+        networks[i].cutoffFilter->processFilters(*buses[i]);
+    }
+
+    for (size_t i = 0; i < networks.size(); ++i)
+        if (!networks[i].processing)
+            buses[i]->clear();
+}
+
+size_t PreProcessingLanes::getSizeInBytes() const {
+    return laneBuffer.getSizeInBytes();
+}
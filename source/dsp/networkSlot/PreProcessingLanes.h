@@ -0,0 +1,40 @@
+#ifndef VAESYNTH_PREPROCESSINGLANES_H
+#define VAESYNTH_PREPROCESSINGLANES_H
+
+#include <JuceHeader.h>
+#include "../../PluginParameters.h"
+#include "../transientSplitter/TransientSplitter.h"
+#include "../Filter/IIRCutoffFilter.h"
+#include "../utils/LaneBuffer.h"
+
+/*  The pre-processing of all network branches in one pass. The input is broadcast into one lane per processing
+ *  network, the transient splitters and cutoff filters run on the lanes side by side and every lane is written to
+ *  its network bus. Networks that are not processing keep their state and get a silent bus. The lanes are float
+ *  only, in double precision every network runs its stages on its own bus instead.
+ */
+class PreProcessingLanes {
+public:
+    template <typename SampleType>
+    struct Network {
+        TransientSplitter<SampleType>* transientSplitter = nullptr;
+        IIRCutoffFilter<SampleType>* cutoffFilter = nullptr;
+        bool processing = false;
+    };
+
+    template <typename SampleType>
+    using Networks = std::array<Network<SampleType>, PluginParameters::NUM_NETWORKS>;
+    template <typename SampleType>
+    using Buses = std::array<juce::AudioBuffer<SampleType>*, PluginParameters::NUM_NETWORKS>;
+
+    void prepare(int maxBlockSize);
+    // the input may be one of the buses, the main bus of the routing graph is the bus of the first network
+    void process(const Networks<float>& networks, const juce::AudioBuffer<float>& input, const Buses<float>& buses);
+    void process(const Networks<double>& networks, const juce::AudioBuffer<double>& input, const Buses<double>& buses);
+
+    size_t getSizeInBytes() const;
+
+private:
+    LaneBuffer laneBuffer;
+};
+
+#endif //VAESYNTH_PREPROCESSINGLANES_H
@@ -0,0 +1,59 @@
+#include "InferencePool.h"
+
+InferencePool::InferencePool() {
+    for (int i = 0; i < getNumWorkers(); ++i) {
+        workers.push_back(std::make_unique<Worker>(*this));
+        workers.back()->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+InferencePool::~InferencePool() {
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+    for (auto& worker : workers)
+        worker->stopThread(2000);
+}
+
+void InferencePool::addJob(Job &job) {
+    const juce::ScopedLock scopedLock(jobLock);
+    jobs.push_back(&job);
+}
+
+void InferencePool::removeJob(Job &job) {
+    const juce::ScopedLock scopedLock(jobLock);
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), &job), jobs.end());
+    nextJob = 0;
+}
+
+int InferencePool::getNumJobs() const {
+    const juce::ScopedLock scopedLock(jobLock);
+    return (int) std::count_if(jobs.begin(), jobs.end(), [] (const Job* job) { return job->isPending(); });
+}
+
+InferencePool::Job *InferencePool::claimPendingJob() {
+    const juce::ScopedLock scopedLock(jobLock);
+
+    // round robin, so one busy slot cannot starve the others
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const size_t index = (nextJob + i) % jobs.size();
+        if (jobs[index]->pending.exchange(false, std::memory_order_acquire)) {
+            nextJob = index + 1;
+            return jobs[index];
+        }
+    }
+    return nullptr;
+}
+
+int InferencePool::getNumWorkers() {
+    // leave one core for the host's audio thread
+    return juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+}
+
+void InferencePool::Worker::run() {
+    while (!threadShouldExit()) {
+        if (auto job = pool.claimPendingJob())
+            job->run();
+        else
+            wait(pollIntervalInMs);
+    }
+}
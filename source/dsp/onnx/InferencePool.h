@@ -0,0 +1,65 @@
+#ifndef VAESYNTH_INFERENCEPOOL_H
+#define VAESYNTH_INFERENCEPOOL_H
+
+#include "JuceHeader.h"
+
+/*  Worker pool shared by every network slot of every plugin instance in the process.
+ *  Access it through juce::SharedResourcePointer<InferencePool> so the threads are created once and torn down
+ *  with the last instance.
+ *
+ *  Every slot registers one preallocated Job up front. Triggering it is a single atomic store, the workers poll the
+ *  registered jobs, so the audio thread never allocates, takes a lock or signals a thread to start an inference.
+ */
+class InferencePool {
+public:
+    class Job {
+    public:
+        virtual ~Job() = default;
+
+        // any thread, wait-free
+        void trigger() { pending.store(true, std::memory_order_release); }
+        bool isPending() const { return pending.load(std::memory_order_relaxed); }
+
+    protected:
+        virtual void run() = 0;
+
+    private:
+        friend class InferencePool;
+        std::atomic<bool> pending {false};
+    };
+
+    InferencePool();
+    ~InferencePool();
+
+    // off the audio thread; a removed job may still be running, its owner has to wait for it
+    void addJob(Job& job);
+    void removeJob(Job& job);
+
+    // triggered jobs that no worker has picked up yet
+    int getNumJobs() const;
+
+private:
+    class Worker : public juce::Thread {
+    public:
+        explicit Worker(InferencePool& owner) : juce::Thread("Scyclone inference worker"), pool(owner) {}
+        void run() override;
+
+    private:
+        InferencePool& pool;
+    };
+
+    Job* claimPendingJob();
+    static int getNumWorkers();
+
+    juce::CriticalSection jobLock;
+    std::vector<Job*> jobs;
+    size_t nextJob = 0;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // an inference has maxModelCalcSize samples of budget, a few milliseconds of polling delay are well within it
+    static constexpr int pollIntervalInMs = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InferencePool)
+};
+
+#endif //VAESYNTH_INFERENCEPOOL_H
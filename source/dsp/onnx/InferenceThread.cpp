@@ -4,17 +4,29 @@
 
 #include "InferenceThread.h"
 
-InferenceThread::InferenceThread(RaveModel raveModel) : juce::Thread("OnnxInference"), session(nullptr), currentLevel(raveModel){
+InferenceThread::InferenceThread(RaveModel raveModel, EventLog& log, int no) : session(nullptr), currentLevel(raveModel), eventLog(log), number(no) {
     modelInputSizeChanged(modelInputSize);
     setInternalModel();
+    inferencePool->addJob(inferenceJob);
 }
 
 InferenceThread::~InferenceThread() {
+    // once removed no worker picks the job up again, one that already has it clears inferenceRunning when done
+    inferencePool->removeJob(inferenceJob);
+    waitForRunningInference();
     session.release();
-    stopThread(100);
 }
 
 void InferenceThread::prepare(const juce::dsp::ProcessSpec &spec) {
+    if (sessionReleased) {
+        session = externalModelFile.existsAsFile() ? createExternalSession(externalModelFile)
+                                                   : createInternalSession(currentLevel);
+        sessionReleased = false;
+    }
+
+    // release() frees the tensors, and a model loaded while suspended clears sessionReleased before it gets here
+    modelInputSizeChanged(modelInputSize);
+
     // allocate enough memory
     receiveRingBuffer.initialise(1, (int) spec.sampleRate);
     
@@ -23,20 +35,54 @@ void InferenceThread::prepare(const juce::dsp::ProcessSpec &spec) {
     init_samples = 0;
 }
 
-void InferenceThread::sendAudio(juce::AudioBuffer<float> &buffer) {
+void InferenceThread::release() {
+    loadingModel.store(true);
+    waitForRunningInference();
+
+    // dropping the session frees its memory arena as well, the model itself is cheap to load again
+    session = Ort::Session(nullptr);
+    sessionReleased = true;
+
+    receiveRingBuffer.initialise(1, 0);
+    processedBuffer.setSize(1, 0);
+    onnxInputData = {};
+    onnxOutputData = {};
+    loadingModel.store(false);
+}
+
+bool InferenceThread::restart() {
+    // a job still in flight would deliver stale output after the restart, so the caller retries on the next block
+    if (inferenceRunning.load() || loadingModel.load()) return false;
+
+    receiveRingBuffer.reset();
+    init = true;
+    init_samples = 0;
+    return true;
+}
+
+void InferenceThread::addMemoryUsage(MemoryUsage &usage) const {
+    usage.add("model session", sessionReleased ? 0 : modelSizeInBytes.load());
+    usage.add("model tensors", MemoryUsage::getSizeInBytes(onnxInputData) + MemoryUsage::getSizeInBytes(onnxOutputData));
+    usage.add("processed buffer", MemoryUsage::getSizeInBytes(processedBuffer));
+    usage.add("receive ring buffer", receiveRingBuffer.getSizeInBytes());
+}
+
+template <typename SampleType>
+void InferenceThread::sendAudio(juce::AudioBuffer<SampleType> &buffer) {
     auto readPointer = buffer.getReadPointer(0);
     for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-        receiveRingBuffer.pushSample(readPointer[sample], 0);
+        receiveRingBuffer.pushSample((float) readPointer[sample], 0);
         if (init) init_samples++;
     }
 
-    if (!isThreadRunning() && receiveRingBuffer.getAvailableSamples(0) >= modelInputSize && !loadingModel) {
+    if (!inferenceRunning.load() && receiveRingBuffer.getAvailableSamples(0) >= modelInputSize && !loadingModel.load()) {
 
         for (float & sample : onnxInputData) {
             sample = receiveRingBuffer.popSample(0);
         }
 
-        startThread(juce::Thread::Priority::highest);
+        inferenceRunning.store(true);
+        inferenceJob.trigger();
     }
     if (init && init_samples >= modelInputSize + maxModelCalcSize) init = false;
 }
@@ -75,13 +121,16 @@ void InferenceThread::run() {
     try {
         session.Run(runOptions, inputNames.data(), inputTensor.get(), 1, outputNames.data(), outputTensor.get(), 1);
     } catch (Ort::Exception &e) {
-        std::cout << e.what() << std::endl;
+        eventLog.log(DiagnosticEvent::Type::inferenceException, number, 0, 0, e.what());
     }
 
     auto stop = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
 
-    // std::cout << duration.count() << "ms" << std::endl;
+    // the output is due maxModelCalcSize samples after the input was complete
+    const auto budget = (juce::int64) (1.0e6 * maxModelCalcSize / last_spec.sampleRate);
+    if (duration.count() > budget)
+        eventLog.log(DiagnosticEvent::Type::deadlineMissed, number, (juce::int64) duration.count(), budget);
 
     for (int i = 0; i < processedBuffer.getNumSamples(); ++i) {
         processedBuffer.setSample(0, i, onnxOutputData[i]);
@@ -91,6 +140,21 @@ void InferenceThread::run() {
 //    ort_alloc.Free(inputName.get());
 }
 
+void InferenceThread::InferenceJob::run() {
+    owner.run();
+    owner.inferenceRunning.store(false);
+}
+
+void InferenceThread::waitForRunningInference() {
+    while (inferenceRunning.load()) {
+        juce::Time::waitForMillisecondCounter(juce::Time::getMillisecondCounter() + 1);
+    }
+}
+
+void InferenceThread::logModelLoaded(const juce::String &modelName) {
+    eventLog.log(DiagnosticEvent::Type::modelLoaded, number, (juce::int64) modelSizeInBytes.load(), 0, modelName.toRawUTF8());
+}
+
 void InferenceThread::setExternalModel(juce::File modelPath) {
     loadExternalModel(modelPath);
 }
@@ -104,36 +168,12 @@ void InferenceThread::modelInputSizeChanged(int newModelInputSize) {
 }
 
 void InferenceThread::loadExternalModel(juce::File modelPath) {
-    loadingModel = true;
-
-    if (isThreadRunning()) {
-        stopThread(10);
-
-        while (!isThreadRunning()) {
-            juce::Time::waitForMillisecondCounter(juce::Time::getMillisecondCounter() + 1);
-        }
-    }
-
-    Ort::SessionOptions sessionOptions;
-
-
-
-#if JUCE_WINDOWS
-    auto modelPathToLoad = modelPath.getFullPathName().toStdString();
-    std::wstring modelWideStr = std::wstring(modelPathToLoad.begin(), modelPathToLoad.end());
-    const wchar_t* modelWideCStr = modelWideStr.c_str();
-
-    session = Ort::Session(env,
-                       modelWideCStr,
-                       sessionOptions);
-#else
-    auto modelPathToLoad = modelPath.getFullPathName().toStdString();
-    const char* modelCStr = modelPathToLoad.c_str();
+    loadingModel.store(true);
+    waitForRunningInference();
 
-    session = Ort::Session(env,
-                           modelCStr,
-                           sessionOptions);
-#endif
+    session = createExternalSession(modelPath);
+    externalModelFile = modelPath;
+    sessionReleased = false;
 
     prepare(last_spec);
 
@@ -142,39 +182,19 @@ void InferenceThread::loadExternalModel(juce::File modelPath) {
     for (int i = 0; i < shape.size(); ++i) {
 //        std::cout << "shape[" <<  i << "]: " << shape[i] << std::endl;
     }
+    logModelLoaded(modelPath.getFileNameWithoutExtension());
     onModelLoaded(modelPath.getFileNameWithoutExtension());
-    loadingModel = false;
+    loadingModel.store(false);
 }
 
 void InferenceThread::loadInternalModel(RaveModel modelToLoad) {
-    loadingModel = true;
-
-    if (isThreadRunning()) {
-        stopThread(10);
-
-        while (!isThreadRunning()) {
-            juce::Time::waitForMillisecondCounter(juce::Time::getMillisecondCounter() + 1);
-        }
-    }
+    loadingModel.store(true);
+    waitForRunningInference();
 
-    Ort::SessionOptions sessionOptions;
+    session = createInternalSession(modelToLoad);
+    externalModelFile = juce::File();
+    sessionReleased = false;
 
-    switch (modelToLoad) {
-        default:
-            //not implemented
-        case FunkDrum:
-            session = Ort::Session(env,
-                                   BinaryData::funk_drums_ort,
-                                   BinaryData::funk_drums_ortSize,
-                                   sessionOptions);
-            break;
-        case Djembe:
-            session = Ort::Session(env,
-                                   BinaryData::djembe_ort,
-                                   BinaryData::djembe_ortSize,
-                                   sessionOptions);
-            break;
-    }
     if (! startUp){
         prepare(last_spec);
     }
@@ -185,12 +205,56 @@ void InferenceThread::loadInternalModel(RaveModel modelToLoad) {
 //        std::cout << "shape[" <<  i << "]: " << shape[i] << std::endl;
     }
     if (! startUp){
+        logModelLoaded(modelToLoad == Djembe ? "Djembe" : "Funk");
         onModelLoaded("");
     }
-    loadingModel = false;
+    loadingModel.store(false);
     startUp = false;
 }
 
+Ort::Session InferenceThread::createExternalSession(const juce::File &modelPath) {
+    Ort::SessionOptions sessionOptions;
+    modelSizeInBytes.store((size_t) modelPath.getSize());
+
+#if JUCE_WINDOWS
+    auto modelPathToLoad = modelPath.getFullPathName().toStdString();
+    std::wstring modelWideStr = std::wstring(modelPathToLoad.begin(), modelPathToLoad.end());
+    const wchar_t* modelWideCStr = modelWideStr.c_str();
+
+    return Ort::Session(env,
+                        modelWideCStr,
+                        sessionOptions);
+#else
+    auto modelPathToLoad = modelPath.getFullPathName().toStdString();
+    const char* modelCStr = modelPathToLoad.c_str();
+
+    return Ort::Session(env,
+                        modelCStr,
+                        sessionOptions);
+#endif
+}
+
+Ort::Session InferenceThread::createInternalSession(RaveModel modelToLoad) {
+    Ort::SessionOptions sessionOptions;
+
+    switch (modelToLoad) {
+        default:
+            //not implemented
+        case FunkDrum:
+            modelSizeInBytes.store((size_t) BinaryData::funk_drums_ortSize);
+            return Ort::Session(env,
+                                BinaryData::funk_drums_ort,
+                                BinaryData::funk_drums_ortSize,
+                                sessionOptions);
+        case Djembe:
+            modelSizeInBytes.store((size_t) BinaryData::djembe_ortSize);
+            return Ort::Session(env,
+                                BinaryData::djembe_ort,
+                                BinaryData::djembe_ortSize,
+                                sessionOptions);
+    }
+}
+
 std::vector<int> InferenceThread::getInputShape(Ort::Session *sess) {
     std::vector<int> returnVec;
     std::vector<int64_t> inputShape = sess->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
@@ -216,3 +280,6 @@ void InferenceThread::setInternalModel() {
             loadInternalModel(FunkDrum);
     }
 }
+
+template void InferenceThread::sendAudio<float>(juce::AudioBuffer<float>&);
+template void InferenceThread::sendAudio<double>(juce::AudioBuffer<double>&);
@@ -9,6 +9,9 @@
 #include "JuceHeader.h"
 #include "onnxruntime_cxx_api.h"
 #include "RingBuffer.h"
+#include "InferencePool.h"
+#include "../utils/MemoryUsage.h"
+#include "../utils/EventLog.h"
 #include "chrono"
 
 enum RaveModel {
@@ -16,15 +19,21 @@ enum RaveModel {
     Djembe
 };
 
-class InferenceThread : public juce::Thread {
+class InferenceThread {
 public:
-    InferenceThread(RaveModel raveModel);
-    ~InferenceThread() override;
+    InferenceThread(RaveModel raveModel, EventLog& log, int no);
+    ~InferenceThread();
 
     void prepare(const juce::dsp::ProcessSpec& spec);
-    void sendAudio(juce::AudioBuffer<float>& buffer);
+    void release();
+    // the model runs in float, double precision input is converted here
+    template <typename SampleType>
+    void sendAudio(juce::AudioBuffer<SampleType>& buffer);
     void setExternalModel(juce::File modelPath);
     int getLatency();
+    bool restart();
+    // the runtime exposes no per-session arena statistics, the session is accounted with the size of its model
+    void addMemoryUsage(MemoryUsage& usage) const;
 
     std::function<int(juce::AudioBuffer<float> buffer)> onNewProcessedBuffer;
     std::function<void(juce::String modelName)> onModelLoaded;
@@ -34,11 +43,27 @@ public:
     void setInternalModel();
 
 private:
-    void run() override;
+    // the preallocated pool job of this thread, the audio thread only triggers it
+    class InferenceJob : public InferencePool::Job {
+    public:
+        explicit InferenceJob(InferenceThread& thread) : owner(thread) {}
+
+    protected:
+        void run() override;
+
+    private:
+        InferenceThread& owner;
+    };
+
+    void run();
+    void waitForRunningInference();
+    void logModelLoaded(const juce::String& modelName);
 
     void modelInputSizeChanged(int newModelInputSize);
     void loadExternalModel(juce::File modelPath);
     void loadInternalModel(RaveModel modelToLoad);
+    Ort::Session createExternalSession(const juce::File& modelPath);
+    Ort::Session createInternalSession(RaveModel modelToLoad);
     std::vector<int> getInputShape(Ort::Session *sess);
 
 private:
@@ -46,10 +71,16 @@ private:
     juce::dsp::ProcessSpec last_spec;
 
     RaveModel currentLevel;
+    EventLog& eventLog;
+    int number;
 
     Ort::Env env;
     Ort::RunOptions runOptions;
     Ort::Session session;
+    // while the host has the plugin suspended the session is dropped, prepare loads the same model again
+    bool sessionReleased = false;
+    juce::File externalModelFile;
+    std::atomic<size_t> modelSizeInBytes {0};
 
     std::vector<float> onnxInputData;
     std::vector<float> onnxOutputData;
@@ -59,6 +90,9 @@ private:
     int modelInputSize = 16384;
     RingBuffer receiveRingBuffer;
 
-    bool loadingModel = false;
+    juce::SharedResourcePointer<InferencePool> inferencePool;
+    InferenceJob inferenceJob {*this};
+    std::atomic<bool> inferenceRunning {false};
+    std::atomic<bool> loadingModel {false};
 };
 #endif //VAESYNTH_INFERENCETHREAD_H
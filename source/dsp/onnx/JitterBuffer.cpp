@@ -0,0 +1,194 @@
+#include "JitterBuffer.h"
+#include "../utils/MemoryUsage.h"
+
+JitterBuffer::JitterBuffer() = default;
+
+void JitterBuffer::prepare(const juce::dsp::ProcessSpec &spec, int maxLagInSamples) {
+    ringBuffer.initialise(1, (int) spec.sampleRate);
+
+    auto fadeLength = juce::jmax(1, (int) (spec.sampleRate * fadeTimeInSeconds));
+    fadeCurve.resize((size_t) fadeLength);
+    for (int i = 0; i < fadeLength; ++i) {
+        auto phase = (float) (i + 1) / (float) fadeLength;
+        fadeCurve[(size_t) i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::pi * phase);
+    }
+
+    setMaxLag(maxLagInSamples);
+    reset();
+}
+
+void JitterBuffer::setMaxLag(int maxLagInSamples) {
+    maxLag = juce::jmax(0, maxLagInSamples);
+}
+
+void JitterBuffer::reset() {
+    ringBuffer.reset();
+    chunksReceived.store(0);
+    chunksSeen = 0;
+    minFillSinceChunk = std::numeric_limits<int>::max();
+    slackMean = 0.f;
+    slackVariance = 0.f;
+    statisticsInitialised = false;
+    lag = 0;
+    targetLag = 0;
+    concealing = false;
+    concealmentPosition = 0;
+    lastOutputSample = 0.f;
+}
+
+void JitterBuffer::release() {
+    ringBuffer.initialise(1, 0);
+    fadeCurve = {};
+    reset();
+}
+
+void JitterBuffer::pushSamples(const float *data, int numSamples) {
+    for (int sample = 0; sample < numSamples; ++sample) {
+        ringBuffer.pushSample(data[sample], 0);
+    }
+    chunksReceived.fetch_add(1, std::memory_order_release);
+}
+
+template <typename SampleType>
+void JitterBuffer::popSamples(SampleType *output, int numSamples) {
+    const int availableSamples = ringBuffer.getAvailableSamples(0);
+    trackArrivals(availableSamples - numSamples);
+
+    if (availableSamples < numSamples) {
+        readSamples(output, availableSamples);
+        concealUnderrun(output + availableSamples, numSamples - availableSamples);
+        lag += numSamples - availableSamples;
+        underrunCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const int excessLag = lag - targetLag;
+    const int skippableSamples = availableSamples - numSamples;
+
+    if (excessLag > 0 && skippableSamples > 0) {
+        const int samplesToSkip = juce::jmin(excessLag, skippableSamples);
+        crossfadeSkip(output, numSamples, samplesToSkip);
+        lag -= samplesToSkip;
+    } else {
+        readSamples(output, numSamples);
+    }
+}
+
+int JitterBuffer::getTargetLag() const {
+    return targetLag;
+}
+
+int JitterBuffer::getUnderrunCount() const {
+    return underrunCount.load(std::memory_order_relaxed);
+}
+
+void JitterBuffer::trackArrivals(int fillAfterBlock) {
+    const int chunks = chunksReceived.load(std::memory_order_acquire);
+
+    if (chunks != chunksSeen) {
+        // the lowest fill level since the previous chunk is the slack the last inference had
+        if (chunksSeen > 0 && minFillSinceChunk != std::numeric_limits<int>::max())
+            updateJitterStatistics(minFillSinceChunk);
+        chunksSeen = chunks;
+        minFillSinceChunk = std::numeric_limits<int>::max();
+    }
+
+    minFillSinceChunk = juce::jmin(minFillSinceChunk, fillAfterBlock);
+}
+
+void JitterBuffer::updateJitterStatistics(int slack) {
+    const auto value = (float) slack;
+
+    if (!statisticsInitialised) {
+        slackMean = value;
+        slackVariance = 0.f;
+        statisticsInitialised = true;
+    } else {
+        const auto delta = value - slackMean;
+        slackMean += statisticsSmoothing * delta;
+        slackVariance = (1.f - statisticsSmoothing) * (slackVariance + statisticsSmoothing * delta * delta);
+    }
+
+    const auto requiredReserve = jitterDeviations * std::sqrt(slackVariance) - slackMean;
+    targetLag = juce::jlimit(0, maxLag, (int) std::ceil(requiredReserve));
+}
+
+template <typename SampleType>
+void JitterBuffer::readSamples(SampleType *output, int numSamples) {
+    if (numSamples <= 0) return;
+
+    if (concealing) {
+        // fade from the concealment tail back into the stream
+        const int fadeSamples = juce::jmin(numSamples, (int) fadeCurve.size());
+        for (int sample = 0; sample < numSamples; ++sample) {
+            const float streamSample = ringBuffer.popSample(0);
+            if (sample < fadeSamples) {
+                const float gain = getFadeGain(sample, fadeSamples);
+                output[sample] = (SampleType) (gain * streamSample + (1.f - gain) * nextConcealmentSample());
+            } else {
+                output[sample] = (SampleType) streamSample;
+            }
+        }
+        concealing = false;
+    } else {
+        for (int sample = 0; sample < numSamples; ++sample) {
+            output[sample] = (SampleType) ringBuffer.popSample(0);
+        }
+    }
+
+    lastOutputSample = (float) output[numSamples - 1];
+}
+
+template <typename SampleType>
+void JitterBuffer::crossfadeSkip(SampleType *output, int numSamples, int samplesToSkip) {
+    const int fadeSamples = juce::jmin(numSamples, (int) fadeCurve.size());
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+        const float syncedSample = ringBuffer.peekSample(0, samplesToSkip + sample);
+        if (sample < fadeSamples) {
+            const float lateSample = concealing ? nextConcealmentSample() : ringBuffer.peekSample(0, sample);
+            const float gain = getFadeGain(sample, fadeSamples);
+            output[sample] = (SampleType) (gain * syncedSample + (1.f - gain) * lateSample);
+        } else {
+            output[sample] = (SampleType) syncedSample;
+        }
+    }
+
+    ringBuffer.skipSamples(0, samplesToSkip + numSamples);
+    concealing = false;
+    lastOutputSample = (float) output[numSamples - 1];
+}
+
+template <typename SampleType>
+void JitterBuffer::concealUnderrun(SampleType *output, int numSamples) {
+    if (!concealing) {
+        concealing = true;
+        concealmentPosition = 0;
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+        output[sample] = (SampleType) nextConcealmentSample();
+    }
+}
+
+float JitterBuffer::nextConcealmentSample() {
+    // tail extension: hold the last played sample and fade it out over the fade length
+    const int fadeLength = (int) fadeCurve.size();
+    if (concealmentPosition >= fadeLength) return 0.f;
+
+    const float gain = fadeCurve[(size_t) (fadeLength - 1 - concealmentPosition)];
+    ++concealmentPosition;
+    return lastOutputSample * gain;
+}
+
+float JitterBuffer::getFadeGain(int position, int fadeSamples) const {
+    const auto index = (size_t) ((position * (int) fadeCurve.size()) / fadeSamples);
+    return fadeCurve[juce::jmin(index, fadeCurve.size() - 1)];
+}
+
+size_t JitterBuffer::getSizeInBytes() const {
+    return ringBuffer.getSizeInBytes() + MemoryUsage::getSizeInBytes(fadeCurve);
+}
+
+template void JitterBuffer::popSamples<float>(float*, int);
+template void JitterBuffer::popSamples<double>(double*, int);
@@ -0,0 +1,78 @@
+#ifndef VAESYNTH_JITTERBUFFER_H
+#define VAESYNTH_JITTERBUFFER_H
+
+#include "JuceHeader.h"
+#include "RingBuffer.h"
+
+/*  Output buffer between the inference thread and the audio thread.
+ *
+ *  Processed chunks arrive in bursts of modelInputSize samples, so the fill level right before a chunk lands is the
+ *  slack the inference had. The buffer tracks mean and variance of that slack and derives a target lag: how far the
+ *  read position may trail the nominal one before it is pulled back. The lag is bounded by maxLag, which the owner
+ *  derives from the reported latency.
+ *
+ *  On underrun the missing part of the block is concealed by fading out the last output sample instead of writing
+ *  a block of zeros. Once data is available again the read position is pulled back to the target by crossfading
+ *  from the concealment (or the late stream) to the re-synced position, so no whole block is ever discarded.
+ *
+ *  The stream is float like the model, popping converts to the sample type of the host.
+ */
+class JitterBuffer {
+public:
+    JitterBuffer();
+
+    void prepare(const juce::dsp::ProcessSpec& spec, int maxLagInSamples);
+    void reset();
+    void release();
+    // not while the audio thread pops, the owner calls it from prepare or with processing suspended
+    void setMaxLag(int maxLagInSamples);
+
+    void pushSamples(const float* data, int numSamples);
+    template <typename SampleType>
+    void popSamples(SampleType* output, int numSamples);
+
+    int getTargetLag() const;
+    int getUnderrunCount() const;
+    size_t getSizeInBytes() const;
+
+private:
+    void trackArrivals(int fillAfterBlock);
+    void updateJitterStatistics(int slack);
+    template <typename SampleType>
+    void readSamples(SampleType* output, int numSamples);
+    template <typename SampleType>
+    void crossfadeSkip(SampleType* output, int numSamples, int samplesToSkip);
+    template <typename SampleType>
+    void concealUnderrun(SampleType* output, int numSamples);
+    float nextConcealmentSample();
+    float getFadeGain(int position, int fadeSamples) const;
+
+private:
+    RingBuffer ringBuffer;
+    std::vector<float> fadeCurve;
+
+    std::atomic<int> chunksReceived {0};
+    std::atomic<int> underrunCount {0};
+    int chunksSeen = 0;
+    int minFillSinceChunk = std::numeric_limits<int>::max();
+
+    float slackMean = 0.f;
+    float slackVariance = 0.f;
+    bool statisticsInitialised = false;
+
+    int lag = 0;
+    int targetLag = 0;
+    int maxLag = 0;
+
+    bool concealing = false;
+    int concealmentPosition = 0;
+    float lastOutputSample = 0.f;
+
+    static constexpr float statisticsSmoothing = 0.1f;
+    static constexpr float jitterDeviations = 3.f;
+    static constexpr double fadeTimeInSeconds = 0.002;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JitterBuffer)
+};
+
+#endif //VAESYNTH_JITTERBUFFER_H
@@ -4,82 +4,73 @@
 
 #include "OnnxProcessor.h"
 
-OnnxProcessor::OnnxProcessor(juce::AudioProcessorValueTreeState &apvts, int no, RaveModel raveModel) : inferenceThread(raveModel), number(no), parameters(apvts)
+OnnxProcessor::OnnxProcessor(juce::AudioProcessorValueTreeState &apvts, int no, RaveModel raveModel, EventLog& log) : inferenceThread(raveModel, log, no), eventLog(log), number(no), parameters(apvts)
 {
     inferenceThread.onNewProcessedBuffer = [this] (juce::AudioBuffer<float> buffer) {
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-            receiveRingBuffer.pushSample(buffer.getSample(0, sample), 0);
-        }
+        jitterBuffer.pushSamples(buffer.getReadPointer(0), buffer.getNumSamples());
         return 0;
     };
 
     inferenceThread.onModelLoaded = [this] (juce::String modelName) {
+        // processing is still suspended here: the new latency and an empty jitter buffer have to be in place before
+        // onOnnxModelLoad resumes it, the audio thread pops from the jitter buffer as soon as it runs again
+        calculateLatency(hostBlockSize);
+        jitterBuffer.setMaxLag(latencyInSamples / maxLagLatencyDivisor);
+        jitterBuffer.reset();
         onOnnxModelLoad(false, modelName);
-        receiveRingBuffer.reset();
-        inferenceCounter = 0;
     };
 }
 
 void OnnxProcessor::parameterChanged(const juce::String &parameterID, float newValue) {
-    if (parameterID == PluginParameters::SELECT_NETWORK1_ID.getParamID() && number == 1) {
+    if (parameterID == PluginParameters::getNetworkIDs(number).select.getParamID()) {
         auto newValueBool = (bool) newValue;
         if (!newValueBool) {
             onOnnxModelLoad(true, "");
             inferenceThread.setInternalModel();
         }
-    } else if (parameterID == PluginParameters::SELECT_NETWORK2_ID.getParamID() && number == 2) {
-        auto newValueBool = (bool) newValue;
-        if (!newValueBool) {
-            onOnnxModelLoad(true, "");
-            inferenceThread.setInternalModel();
-        }
-    } else if (parameterID == PluginParameters::ON_OFF_NETWORK1_ID.getParamID() && number == 1) {
-//        setMuted(!(bool) newValue);
-    } else if (parameterID == PluginParameters::ON_OFF_NETWORK2_ID.getParamID() && number == 2) {
-//        setMuted(!(bool)newValue);
     }
 }
 
-void OnnxProcessor::prepare(const juce::dsp::ProcessSpec &spec) {
-    receiveRingBuffer.initialise(1, (int) spec.sampleRate);
-    monoBuffer.setSize(1, (int) spec.maximumBlockSize);
+void OnnxProcessor::prepare(const juce::dsp::ProcessSpec &spec, int samplesPerBlock) {
     inferenceThread.prepare(spec);
-    inferenceCounter = 0;
-    calculateLatency((int)spec.maximumBlockSize);
+    // the latency is rounded to whole host blocks, some hosts announce no block size at all
+    hostBlockSize = juce::jmax(1, samplesPerBlock);
+    calculateLatency(hostBlockSize);
+    jitterBuffer.prepare(spec, latencyInSamples / maxLagLatencyDivisor);
 
     if (spec.sampleRate != 48000.0) {
         warningWindow.showWarningWindow(SampleRateWarning);
     }
 }
 
-void OnnxProcessor::processBlock(juce::AudioBuffer<float> &buffer) {
+void OnnxProcessor::release() {
+    inferenceThread.release();
+    jitterBuffer.release();
+}
+
+void OnnxProcessor::addMemoryUsage(MemoryUsage &usage) const {
+    inferenceThread.addMemoryUsage(usage);
+    usage.add("jitter buffer", jitterBuffer.getSizeInBytes());
+}
+
+template <typename SampleType>
+void OnnxProcessor::processBlock(juce::AudioBuffer<SampleType> &buffer) {
     const int numSamples = buffer.getNumSamples();
     inferenceThread.sendAudio(buffer);
     processOutput(buffer, numSamples);
 }
 
-void OnnxProcessor::processOutput(juce::AudioBuffer<float> &buffer, const int numSamples) {
-    auto availableSamples = receiveRingBuffer.getAvailableSamples(0);
+template <typename SampleType>
+void OnnxProcessor::processOutput(juce::AudioBuffer<SampleType> &buffer, const int numSamples) {
     if (!inferenceThread.init){
-        if (availableSamples >= numSamples) {
-            if (inferenceCounter > 0) {
-                if (availableSamples >= 2 * numSamples) {
-                    for (int i = 0; i < numSamples; ++i) {
-                        receiveRingBuffer.popSample(0);
-                    }
-                    inferenceCounter--;
-                }
-            }
-            for (int sample = 0; sample < numSamples; ++sample) {
-                buffer.setSample(0, sample, receiveRingBuffer.popSample(0));
-            }
-        } else {
-            inferenceCounter++;
-            std::cout << "missing samples" << std::endl;
-            for (int sample = 0; sample < numSamples; ++sample) {
-                buffer.setSample(0, sample, 0.0f);
-            }
-        }
+        const int underrunsBefore = jitterBuffer.getUnderrunCount();
+        jitterBuffer.popSamples(buffer.getWritePointer(0), numSamples);
+
+        const int underruns = jitterBuffer.getUnderrunCount();
+        const bool underrun = underruns != underrunsBefore;
+        if (underrun && !inUnderrun)
+            eventLog.log(DiagnosticEvent::Type::underrun, number, underruns, jitterBuffer.getTargetLag());
+        inUnderrun = underrun;
     }
 }
 
@@ -88,12 +79,25 @@ void OnnxProcessor::loadExternalModel(juce::File file) {
     inferenceThread.setExternalModel(file);
 }
 
-void OnnxProcessor::calculateLatency(int maxSamplesPerBuffer) {
-    float latency = (float) (inferenceThread.getLatency()) / (float) maxSamplesPerBuffer;
-    if (latency == static_cast<float>(static_cast<int>(latency))) latencyInSamples = static_cast<int>(latency) * maxSamplesPerBuffer - maxSamplesPerBuffer;
-    else latencyInSamples = static_cast<int>((latency + 1.f)) * maxSamplesPerBuffer - maxSamplesPerBuffer;
+void OnnxProcessor::calculateLatency(int samplesPerBlock) {
+    float latency = (float) (inferenceThread.getLatency()) / (float) samplesPerBlock;
+    if (latency == static_cast<float>(static_cast<int>(latency))) latencyInSamples = static_cast<int>(latency) * samplesPerBlock - samplesPerBlock;
+    else latencyInSamples = static_cast<int>((latency + 1.f)) * samplesPerBlock - samplesPerBlock;
 }
 
 int OnnxProcessor::getLatency() const {
     return latencyInSamples;
 }
+
+bool OnnxProcessor::restart() {
+    if (!inferenceThread.restart()) return false;
+    jitterBuffer.reset();
+    return true;
+}
+
+bool OnnxProcessor::isWarmingUp() const {
+    return inferenceThread.init;
+}
+
+template void OnnxProcessor::processBlock<float>(juce::AudioBuffer<float>&);
+template void OnnxProcessor::processBlock<double>(juce::AudioBuffer<double>&);
@@ -6,26 +6,32 @@
 #define VAESYNTH_ONNXPROCESSOR_H
 
 #include "JuceHeader.h"
-#include "RingBuffer.h"
+#include "JitterBuffer.h"
 #include "InferenceThread.h"
 #include "../../PluginParameters.h"
 #include "WarningWindow.h"
 
 class OnnxProcessor {
 public:
-    OnnxProcessor(juce::AudioProcessorValueTreeState &apvts, int no, RaveModel raveModel);
+    OnnxProcessor(juce::AudioProcessorValueTreeState &apvts, int no, RaveModel raveModel, EventLog& log);
 
     void parameterChanged(const juce::String &parameterID, float newValue);
-    void prepare(const juce::dsp::ProcessSpec& spec);
-    void processBlock(juce::AudioBuffer<float>& buffer);
+    void prepare(const juce::dsp::ProcessSpec& spec, int samplesPerBlock);
+    void release();
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
     int getLatency() const;
+    bool restart();
+    bool isWarmingUp() const;
+    void addMemoryUsage(MemoryUsage& usage) const;
     void loadExternalModel(juce::File path);
 
     std::function<void(bool initLoading, juce::String modelName)> onOnnxModelLoad;
 
 private:
-    void processOutput(juce::AudioBuffer<float>& buffer, int numSamples);
-    void calculateLatency(int maxSamplesPerBuffer);
+    template <typename SampleType>
+    void processOutput(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+    void calculateLatency(int samplesPerBlock);
 
 
 private:
@@ -33,12 +39,18 @@ private:
 
     InferenceThread inferenceThread;
     int latencyInSamples = 0;
-    RingBuffer receiveRingBuffer;
-    juce::AudioBuffer<float> monoBuffer;
-    int inferenceCounter = 0;
+    // the block size the host announced in prepareToPlay, not the sub-block size the DSP runs at
+    int hostBlockSize = 512;
+    JitterBuffer jitterBuffer;
+    EventLog& eventLog;
+    // an underrun lasts over several blocks, it is logged once when it starts
+    bool inUnderrun = false;
     std::unique_ptr<juce::FileChooser> fc;
     WarningWindow warningWindow;
     int number;
+
+    // the jitter buffer may trail the nominal read position by at most this fraction of the reported latency
+    static constexpr int maxLagLatencyDivisor = 32;
 };
 
 #endif //VAESYNTH_ONNXPROCESSOR_H
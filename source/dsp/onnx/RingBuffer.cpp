@@ -3,6 +3,7 @@
 //
 
 #include "RingBuffer.h"
+#include "../utils/MemoryUsage.h"
 
 RingBuffer::RingBuffer() = default;
 
@@ -27,10 +28,6 @@ void RingBuffer::reset() {
 }
 
 void RingBuffer::pushSample(float sample, int channel) {
-    if (isnan(sample)){
-        sample = 0.f;
-//        std::cout << "Sample is nan! push" << std::endl; //DBG
-    }
     buffer.setSample(channel, writePos[channel], sample);
 
     ++writePos[channel];
@@ -48,17 +45,19 @@ float RingBuffer::popSample(int channel) {
     if (readPos[channel] >= buffer.getNumSamples()) {
         readPos[channel] = 0;
     }
-    if (isnan(sample)){
-//        std::cout << "Sample is nan! pop" << std::endl; //DBG
-        return 0.f;
-    }
-    else return sample;
+    return sample;
 }
 
-int RingBuffer::getAvailableSamples(int channel, bool debug) {
-    if (debug) {
-        std::cout << "getAvailableSamples["<< readPos[channel] << ", " << writePos[channel] << "]: ";
-    }
+float RingBuffer::peekSample(int channel, int offset) {
+    auto position = (readPos[channel] + offset) % buffer.getNumSamples();
+    return buffer.getSample(channel, position);
+}
+
+void RingBuffer::skipSamples(int channel, int numSamples) {
+    readPos[channel] = (readPos[channel] + numSamples) % buffer.getNumSamples();
+}
+
+int RingBuffer::getAvailableSamples(int channel) {
     int returnValue;
 
     if (readPos[channel] <= writePos[channel]) {
@@ -67,10 +66,9 @@ int RingBuffer::getAvailableSamples(int channel, bool debug) {
         returnValue = writePos[channel] + buffer.getNumSamples() - readPos[channel];
     }
 
-    if (debug) {
-        std::cout << returnValue << std::endl;
-    }
-
-
     return returnValue;
 }
+
+size_t RingBuffer::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(buffer) + MemoryUsage::getSizeInBytes(readPos) + MemoryUsage::getSizeInBytes(writePos);
+}
@@ -16,7 +16,10 @@ public:
     void reset();
     void pushSample(float sample, int channel);
     float popSample(int channel);
-    int getAvailableSamples(int channel, bool debug = false);
+    float peekSample(int channel, int offset);
+    void skipSamples(int channel, int numSamples);
+    int getAvailableSamples(int channel);
+    size_t getSizeInBytes() const;
 
 private:
     juce::AudioBuffer<float> buffer;
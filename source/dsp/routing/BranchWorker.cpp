@@ -0,0 +1,81 @@
+#include "BranchWorker.h"
+
+BranchWorker::BranchWorker() : juce::Thread("Scyclone branch worker") {}
+
+BranchWorker::~BranchWorker() {
+    stop();
+}
+
+void BranchWorker::start() {
+    if (isThreadRunning()) return;
+
+    startThread(juce::Thread::Priority::highest);
+    available.store(true);
+}
+
+void BranchWorker::stop() {
+    available.store(false);
+    signalThreadShouldExit();
+    notify();
+    stopThread(1000);
+}
+
+bool BranchWorker::isAvailable() const {
+    return available.load(std::memory_order_acquire);
+}
+
+void BranchWorker::fork(Job newJob, void *newContext) {
+    jassert (state.load() == idle);
+
+    job = newJob;
+    context = newContext;
+    numForks.fetch_add(1, std::memory_order_relaxed);
+    state.store(pending, std::memory_order_release);
+}
+
+void BranchWorker::join() {
+    for (int spin = 0; spin < maxJoinSpins && state.load(std::memory_order_acquire) == pending; ++spin)
+        std::this_thread::yield();
+
+    // still not picked up: the worker is parked or gone, running the job here is faster than waiting for it
+    tryRunJob();
+
+    // otherwise the worker is running the job, wait for that share of the block only
+    while (state.load(std::memory_order_acquire) != done)
+        std::this_thread::yield();
+    state.store(idle, std::memory_order_relaxed);
+}
+
+bool BranchWorker::tryRunJob() {
+    int expected = pending;
+    if (!state.compare_exchange_strong(expected, running))
+        return false;
+
+    job(context);
+    state.store(done, std::memory_order_release);
+    return true;
+}
+
+void BranchWorker::run() {
+    juce::ScopedNoDenormals noDenormals;
+    auto lastJobTime = juce::Time::getMillisecondCounterHiRes();
+
+    while (!threadShouldExit()) {
+        if (tryRunJob()) {
+            lastJobTime = juce::Time::getMillisecondCounterHiRes();
+            continue;
+        }
+
+        if (juce::Time::getMillisecondCounterHiRes() - lastJobTime < spinTimeInMs) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // parked: nobody wakes the worker, it polls until forks come in again and then resumes spinning
+        const auto forksWhenParked = numForks.load(std::memory_order_relaxed);
+        while (!threadShouldExit() && state.load(std::memory_order_acquire) != pending
+               && numForks.load(std::memory_order_relaxed) == forksWhenParked)
+            wait(parkPollIntervalInMs);
+        lastJobTime = juce::Time::getMillisecondCounterHiRes();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef VAESYNTH_BRANCHWORKER_H
+#define VAESYNTH_BRANCHWORKER_H
+
+#include <JuceHeader.h>
+
+/*  Second thread for fork-join processing inside processBlock: the audio thread forks one job, processes its own
+ *  share of the block and joins before it needs the result.
+ *
+ *  Forking and joining are atomic operations only, the audio thread never signals or locks. After a job the worker
+ *  spins for a short while so the next block is picked up at once, then it parks by polling. A job the worker has not
+ *  started shortly after join is called is taken back and run on the calling thread, so a parked or stopped worker
+ *  costs no more than not forking. A parked worker that sees forks again goes back to spinning.
+ */
+class BranchWorker : private juce::Thread {
+public:
+    using Job = void (*)(void* context);
+
+    BranchWorker();
+    ~BranchWorker() override;
+
+    // message thread
+    void start();
+    void stop();
+
+    // audio thread
+    bool isAvailable() const;
+    void fork(Job newJob, void* newContext);
+    void join();
+
+private:
+    void run() override;
+    bool tryRunJob();
+
+    enum State {
+        idle,
+        pending,
+        running,
+        done
+    };
+
+    std::atomic<int> state {idle};
+    std::atomic<bool> available {false};
+    std::atomic<uint32_t> numForks {0};
+
+    Job job = nullptr;
+    void* context = nullptr;
+
+    static constexpr double spinTimeInMs = 1.0;
+    static constexpr int parkPollIntervalInMs = 1;
+    static constexpr int maxJoinSpins = 64;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BranchWorker)
+};
+
+#endif //VAESYNTH_BRANCHWORKER_H
@@ -0,0 +1,70 @@
+#include "BufferArena.h"
+
+template <typename SampleType>
+void BufferArena<SampleType>::prepare(int newNumBuffers, int newNumChannels, int newMaxBlockSize) {
+    numBuffers = juce::jmax(0, newNumBuffers);
+    numChannels = juce::jmax(1, newNumChannels);
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    channelStride = (maxBlockSize + alignmentInSamples - 1) / alignmentInSamples * alignmentInSamples;
+
+    const auto numSamplesInTotal = (size_t) (numBuffers * numChannels * channelStride + alignmentInSamples);
+    memory.calloc(numSamplesInTotal);
+
+    auto address = reinterpret_cast<uintptr_t>(memory.get());
+    const auto alignmentInBytes = (uintptr_t) alignmentInSamples * sizeof(SampleType);
+    auto* base = reinterpret_cast<SampleType*>((address + alignmentInBytes - 1) & ~(alignmentInBytes - 1));
+
+    channelPointers.resize((size_t) (numBuffers * numChannels));
+    for (size_t i = 0; i < channelPointers.size(); ++i)
+        channelPointers[i] = base + i * (size_t) channelStride;
+
+    views.clear();
+    views.resize((size_t) numBuffers);
+    for (int i = 0; i < numBuffers; ++i)
+        getBuffer(i, maxBlockSize);
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType> &BufferArena<SampleType>::getBuffer(int index, int numSamples) {
+    jassert (index >= 0 && index < numBuffers);
+    jassert (numSamples <= maxBlockSize);
+
+    // the channel pointer array lives inside the AudioBuffer for small channel counts, so this does not allocate
+    auto& view = views[(size_t) index];
+    view.setDataToReferTo(channelPointers.data() + index * numChannels, numChannels, numSamples);
+    return view;
+}
+
+template <typename SampleType>
+juce::dsp::AudioBlock<SampleType> BufferArena<SampleType>::getBlock(int index, int numSamples) const {
+    jassert (index >= 0 && index < numBuffers);
+    jassert (numSamples <= maxBlockSize);
+
+    return { channelPointers.data() + index * numChannels, (size_t) numChannels, (size_t) numSamples };
+}
+
+template <typename SampleType>
+void BufferArena<SampleType>::release() {
+    memory.free();
+    channelPointers = {};
+    views = {};
+    numBuffers = 0;
+}
+
+template <typename SampleType>
+int BufferArena<SampleType>::getNumBuffers() const {
+    return numBuffers;
+}
+
+template <typename SampleType>
+int BufferArena<SampleType>::getMaxBlockSize() const {
+    return maxBlockSize;
+}
+
+template <typename SampleType>
+size_t BufferArena<SampleType>::getSizeInBytes() const {
+    return (size_t) (numBuffers * numChannels * channelStride) * sizeof(SampleType);
+}
+
+template class BufferArena<float>;
+template class BufferArena<double>;
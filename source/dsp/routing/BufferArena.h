@@ -0,0 +1,37 @@
+#ifndef VAESYNTH_BUFFERARENA_H
+#define VAESYNTH_BUFFERARENA_H
+
+#include <JuceHeader.h>
+
+/*  One aligned allocation holding every intermediate buffer of the processing chain. Each buffer is a fixed slice
+ *  of maxBlockSize samples per channel and is handed out as a view, so asking for a buffer never allocates or
+ *  copies. All memory is reserved in prepare.
+ */
+template <typename SampleType>
+class BufferArena {
+public:
+    void prepare(int numBuffers, int numChannels, int maxBlockSize);
+    void release();
+
+    juce::AudioBuffer<SampleType>& getBuffer(int index, int numSamples);
+    juce::dsp::AudioBlock<SampleType> getBlock(int index, int numSamples) const;
+
+    int getNumBuffers() const;
+    int getMaxBlockSize() const;
+    size_t getSizeInBytes() const;
+
+private:
+    juce::HeapBlock<SampleType> memory;
+    std::vector<SampleType*> channelPointers;
+    std::vector<juce::AudioBuffer<SampleType>> views;
+
+    int numBuffers = 0;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+    int channelStride = 0;
+
+    // 64 bytes, one cache line and the widest vector register
+    static constexpr int alignmentInSamples = 64 / (int) sizeof(SampleType);
+};
+
+#endif //VAESYNTH_BUFFERARENA_H
@@ -0,0 +1,86 @@
+#include "RoutingGraph.h"
+
+template <typename SampleType>
+void RoutingGraph<SampleType>::prepare(const juce::dsp::ProcessSpec &monoSpec) {
+    arena.prepare(numSlots, (int) monoSpec.numChannels, (int) monoSpec.maximumBlockSize);
+    tapReferences.fill(0);
+    beginBlock((int) monoSpec.maximumBlockSize);
+}
+
+template <typename SampleType>
+void RoutingGraph<SampleType>::release() {
+    arena.release();
+    networkBuses = {};
+    numSamples = 0;
+}
+
+template <typename SampleType>
+void RoutingGraph<SampleType>::beginBlock(int newNumSamples) {
+    jassert (newNumSamples <= arena.getMaxBlockSize());
+    numSamples = newNumSamples;
+
+    for (int i = 0; i < PluginParameters::NUM_NETWORKS; ++i)
+        networkBuses[(size_t) i] = &arena.getBuffer(getNetworkSlot(i), numSamples);
+}
+
+template <typename SampleType>
+void RoutingGraph<SampleType>::endBlock() {
+    // every stage that acquired a tap has to release it within the block
+    jassert (std::all_of(tapReferences.begin(), tapReferences.end(), [] (int references) { return references == 0; }));
+    tapReferences.fill(0);
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType> &RoutingGraph<SampleType>::getMainBus() {
+    return *networkBuses[0];
+}
+
+template <typename SampleType>
+const std::array<juce::AudioBuffer<SampleType>*, PluginParameters::NUM_NETWORKS> &RoutingGraph<SampleType>::getNetworkBuses() const {
+    return networkBuses;
+}
+
+template <typename SampleType>
+juce::dsp::AudioBlock<SampleType> RoutingGraph<SampleType>::acquireTap(int tap, const juce::AudioBuffer<SampleType> &source) {
+    jassert (tap >= 0 && tap < numTaps);
+
+    auto block = arena.getBlock(getTapSlot(tap), numSamples);
+    if (tapReferences[(size_t) tap]++ == 0)
+        block.copyFrom(source, 0, 0, (size_t) numSamples);
+
+    return block;
+}
+
+template <typename SampleType>
+void RoutingGraph<SampleType>::releaseTap(int tap) {
+    jassert (tapReferences[(size_t) tap] > 0);
+    --tapReferences[(size_t) tap];
+}
+
+template <typename SampleType>
+int RoutingGraph<SampleType>::getNumSamples() const {
+    return numSamples;
+}
+
+template <typename SampleType>
+size_t RoutingGraph<SampleType>::getSizeInBytes() const {
+    return arena.getSizeInBytes();
+}
+
+template <typename SampleType>
+int RoutingGraph<SampleType>::getGrainDryTap(int networkIndex) {
+    return grainDry + networkIndex;
+}
+
+template <typename SampleType>
+int RoutingGraph<SampleType>::getNetworkSlot(int networkIndex) {
+    return mainSlot + networkIndex;
+}
+
+template <typename SampleType>
+int RoutingGraph<SampleType>::getTapSlot(int tap) {
+    return PluginParameters::NUM_NETWORKS + tap;
+}
+
+template class RoutingGraph<float>;
+template class RoutingGraph<double>;
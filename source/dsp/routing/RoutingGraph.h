@@ -0,0 +1,57 @@
+#ifndef VAESYNTH_ROUTINGGRAPH_H
+#define VAESYNTH_ROUTINGGRAPH_H
+
+#include <JuceHeader.h>
+#include "BufferArena.h"
+#include "../../PluginParameters.h"
+
+/*  Static signal flow of the mono chain, laid out once in prepare over a single BufferArena.
+ *
+ *  The main bus carries the signal from the input stage to the output stage and every stage processes it in place.
+ *  The networks fan out from it: the pre-processing reads the main bus once and writes every network bus, and the
+ *  first network bus is the main bus itself, because nothing reads the input after the fan-out. The network mixer
+ *  writes its result back into the first network's bus, which is the main bus again.
+ *
+ *  Dry taps hold the dry signal of a mix stage. They are reference counted: the first acquire in a block copies the
+ *  source, further acquires share that copy, and a tap nobody acquires costs nothing.
+ */
+template <typename SampleType>
+class RoutingGraph {
+public:
+    enum Tap {
+        compressorDry,
+        grainDry,
+        numTaps = grainDry + PluginParameters::NUM_NETWORKS
+    };
+
+    void prepare(const juce::dsp::ProcessSpec& monoSpec);
+    void release();
+    void beginBlock(int numSamples);
+    void endBlock();
+
+    juce::AudioBuffer<SampleType>& getMainBus();
+    const std::array<juce::AudioBuffer<SampleType>*, PluginParameters::NUM_NETWORKS>& getNetworkBuses() const;
+
+    juce::dsp::AudioBlock<SampleType> acquireTap(int tap, const juce::AudioBuffer<SampleType>& source);
+    void releaseTap(int tap);
+
+    int getNumSamples() const;
+    size_t getSizeInBytes() const;
+
+    static int getGrainDryTap(int networkIndex);
+
+private:
+    static int getNetworkSlot(int networkIndex);
+    static int getTapSlot(int tap);
+
+    BufferArena<SampleType> arena;
+    std::array<juce::AudioBuffer<SampleType>*, PluginParameters::NUM_NETWORKS> networkBuses {};
+    std::array<int, numTaps> tapReferences {};
+    int numSamples = 0;
+
+    // arena layout: the main bus doubles as the first network bus, then the other networks, then the taps
+    static constexpr int mainSlot = 0;
+    static constexpr int numSlots = PluginParameters::NUM_NETWORKS + numTaps;
+};
+
+#endif //VAESYNTH_ROUTINGGRAPH_H
@@ -7,61 +7,37 @@
 
 #include "ProcessorTransientSplitter.h"
 
-ProcessorTransientSplitter::ProcessorTransientSplitter(const juce::AudioProcessorValueTreeState &apvts, int no): index(no), transientSplitter(){
-    if (!isMuted){
-        if (index == 1) {
-            transientSplitter.setAttackTime(apvts.getRawParameterValue(PluginParameters::TRAN_ATTACK_TIME_NETWORK1_ID.getParamID())->load());
-            float tran1_value = apvts.getRawParameterValue(PluginParameters::TRAN_SHAPER_NETWORK1_ID.getParamID())->load();
-            if (tran1_value < 0.5f) {
-                transientSplitter.setAttack(1.f);
-                transientSplitter.setSustain(tran1_value*2.f);
-            }
-            else {
-                transientSplitter.setAttack(1.f - ((tran1_value-0.5f)*2.f));
-                transientSplitter.setAttack(1.f);
-            }
-        } else if (index == 2) {
-            transientSplitter.setAttackTime(apvts.getRawParameterValue(PluginParameters::TRAN_ATTACK_TIME_NETWORK2_ID.getParamID())->load());
-            float tran2_value = apvts.getRawParameterValue(PluginParameters::TRAN_SHAPER_NETWORK2_ID.getParamID())->load();
-            if (tran2_value < 0.5f) {
-                transientSplitter.setAttack(1.f);
-                transientSplitter.setSustain(tran2_value*2.f);
-            }
-            else {
-                transientSplitter.setAttack(1.f - ((tran2_value-0.5f)*2.f));
-                transientSplitter.setAttack(1.f);
-            }
-        }
-    }
+ProcessorTransientSplitter::ProcessorTransientSplitter(const juce::AudioProcessorValueTreeState &apvts, int no): index(no){
+    const auto& networkIDs = PluginParameters::getNetworkIDs(index);
+    const float attackTime = apvts.getRawParameterValue(networkIDs.tranAttackTime.getParamID())->load();
+    transientSplitters.forEach([attackTime] (auto& transientSplitter) { transientSplitter.setAttackTime(attackTime); });
+    setTransientShaper(apvts.getRawParameterValue(networkIDs.tranShaper.getParamID())->load());
 }
 
 ProcessorTransientSplitter::~ProcessorTransientSplitter() = default;
 
-void ProcessorTransientSplitter::prepare(const juce::dsp::ProcessSpec &spec){
-    transientSplitter.prepare(spec);
+void ProcessorTransientSplitter::prepare(const juce::dsp::ProcessSpec &spec, juce::AudioProcessor::ProcessingPrecision precision){
+    transientSplitters.prepare(precision, spec);
 }
 
-void ProcessorTransientSplitter::processBlock(juce::AudioBuffer<float>& buffer){
-    transientSplitter.processBlock(buffer);
+template <typename SampleType>
+void ProcessorTransientSplitter::processBlock(juce::AudioBuffer<SampleType>& buffer){
+    transientSplitters.get<SampleType>().processBlock(buffer);
 }
 
-void ProcessorTransientSplitter::parameterChanged(const juce::String &parameterID, float newValue){
-    if (parameterID == PluginParameters::TRAN_ATTACK_TIME_NETWORK1_ID.getParamID() && index == 1) {
-        transientSplitter.setAttackTime(newValue);
-    } else if (parameterID == PluginParameters::TRAN_SHAPER_NETWORK1_ID.getParamID() && index == 1) {
-//            std::cout << "New Value: " << newValue << ", Index: " << index << std::endl; // DBG
-        if (newValue < 0.5f) {
-            transientSplitter.setAttack(1.f);
-            transientSplitter.setSustain(newValue*2.f);
-        }
-        else {
-            transientSplitter.setAttack(1.f - ((newValue-0.5f)*2.f));
-            transientSplitter.setSustain(1.f);
-        }
-    } else if (parameterID == PluginParameters::TRAN_ATTACK_TIME_NETWORK2_ID.getParamID() && index == 2) {
-            transientSplitter.setAttackTime(newValue);
-    } else if (parameterID == PluginParameters::TRAN_SHAPER_NETWORK2_ID.getParamID() && index == 2) {
-//            std::cout << "New Value: " << newValue << ", Index: " << index << std::endl; // DBG
+void ProcessorTransientSplitter::setParameters(const NetworkParameterSnapshot &snapshot){
+    transientSplitters.forEach([&snapshot] (auto& transientSplitter) {
+        if (snapshot.transientAttackTime != transientSplitter.getAttackTime())
+            transientSplitter.setAttackTime(snapshot.transientAttackTime);
+    });
+    if (snapshot.transientShaper != transientShaper)
+        setTransientShaper(snapshot.transientShaper);
+    setMuted(!snapshot.onOff);
+}
+
+void ProcessorTransientSplitter::setTransientShaper(float newValue) {
+    transientShaper = newValue;
+    transientSplitters.forEach([newValue] (auto& transientSplitter) {
         if (newValue < 0.5f) {
             transientSplitter.setAttack(1.f);
             transientSplitter.setSustain(newValue*2.f);
@@ -70,13 +46,16 @@ void ProcessorTransientSplitter::parameterChanged(const juce::String &parameterI
             transientSplitter.setAttack(1.f - ((newValue-0.5f)*2.f));
             transientSplitter.setSustain(1.f);
         }
-    } else if (parameterID == PluginParameters::ON_OFF_NETWORK1_ID.getParamID() && index == 1){
-        setMuted(!newValue);
-    } else if (parameterID == PluginParameters::ON_OFF_NETWORK2_ID.getParamID() && index == 2){
-        setMuted(!newValue);
-    }
+    });
 }
 
 void ProcessorTransientSplitter::setMuted(bool shouldBeMuted) {
     isMuted = shouldBeMuted;
 }
+
+size_t ProcessorTransientSplitter::getSizeInBytes() const {
+    return transientSplitters.getSizeInBytes();
+}
+
+template void ProcessorTransientSplitter::processBlock<float>(juce::AudioBuffer<float>&);
+template void ProcessorTransientSplitter::processBlock<double>(juce::AudioBuffer<double>&);
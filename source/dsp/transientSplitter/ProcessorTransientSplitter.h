@@ -10,21 +10,31 @@
 
 #include <JuceHeader.h>
 #include "TransientSplitter.h"
-#include "../../PluginParameters.h"
+#include "../utils/PerPrecision.h"
+#include "../../ParameterSnapshot.h"
 
 class ProcessorTransientSplitter{
 public:
     ProcessorTransientSplitter(const juce::AudioProcessorValueTreeState &apvts, int no);
     ~ProcessorTransientSplitter();
     
-    void prepare(const juce::dsp::ProcessSpec &spec);
-    void processBlock(juce::AudioBuffer<float>& buffer);
-    void parameterChanged(const juce::String &parameterID, float newValue);
+    void prepare(const juce::dsp::ProcessSpec &spec, juce::AudioProcessor::ProcessingPrecision precision);
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
+    void setParameters(const NetworkParameterSnapshot& snapshot);
     void setMuted (bool shouldBeMuted);
+    template <typename SampleType>
+    TransientSplitter<SampleType>& getTransientSplitter() { return transientSplitters.get<SampleType>(); }
+    size_t getSizeInBytes() const;
+
+private:
+    void setTransientShaper(float newValue);
 
 private:
     int index;
-    TransientSplitter transientSplitter;
+    // both splitters follow the parameters, only the one for the host's precision is prepared
+    PerPrecision<TransientSplitter> transientSplitters;
+    float transientShaper = 0.f;
     bool isMuted = false;
 
 };
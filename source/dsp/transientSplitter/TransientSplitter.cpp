@@ -8,83 +8,189 @@
 #include "TransientSplitter.h"
 #include "../utils/utils.h"
 
-TransientSplitter::TransientSplitter() : detector(parameter.attackTimeDetector, (parameter.releaseTimeRatio*parameter.releaseTime)), envelope1(0.f, parameter.releaseTime), envelope2(parameter.attackTime, parameter.releaseTime){}
+template <typename SampleType>
+TransientSplitter<SampleType>::TransientSplitter() : detector(parameter.attackTimeDetector, (parameter.releaseTimeRatio*parameter.releaseTime)), envelope1(0.f, parameter.releaseTime), envelope2(parameter.attackTime, parameter.releaseTime){}
 
-TransientSplitter::~TransientSplitter() = default;
+template <typename SampleType>
+TransientSplitter<SampleType>::~TransientSplitter() = default;
 
-void TransientSplitter::prepare(const juce::dsp::ProcessSpec &spec) {
+template <typename SampleType>
+void TransientSplitter<SampleType>::prepare(const juce::dsp::ProcessSpec &spec) {
     detector.prepare(spec);
     envelope1.prepare(spec);
     envelope2.prepare(spec);
 }
 
-void TransientSplitter::processBlock(juce::AudioBuffer<float> &buffer){
-    detector.processBlock(buffer);
-    envelope1.processBlock(buffer);
-    envelope2.processBlock(buffer);
-    for (int i = 0; i < buffer.getNumChannels(); i++){
-        for (int j = 0; j < buffer.getNumSamples(); j++){
-            float attack;
-            float sustain;
-            attack = std::abs(envelope1.getSample((unsigned long) j) - envelope2.getSample((unsigned long) j));
-            attack = std::min(attack/std::abs(detector.getSample((unsigned long) j)), 1.f);
-            sustain = 1.f - attack;
-            float signalAttack = attack * parameter.attack * buffer.getSample(i, j);
-            float signalSustain = sustain * parameter.sustain * buffer.getSample(i, j);
-            buffer.setSample(i, j, signalAttack + signalSustain);
+template <typename SampleType>
+void TransientSplitter<SampleType>::release() {
+    detector.release();
+    envelope1.release();
+    envelope2.release();
+}
+
+template <typename SampleType>
+void TransientSplitter<SampleType>::processBlock(juce::AudioBuffer<SampleType> &buffer){
+    // envelope1 always has an instant attack, so only the detector and envelope2 need dispatching
+    const bool instantDetector = detector.hasInstantAttack();
+    const bool instantEnvelope = envelope2.hasInstantAttack();
+
+    if (instantDetector && instantEnvelope) processBlockInternal<true, true>(buffer);
+    else if (instantDetector) processBlockInternal<true, false>(buffer);
+    else if (instantEnvelope) processBlockInternal<false, true>(buffer);
+    else processBlockInternal<false, false>(buffer);
+}
+
+template <typename SampleType>
+template <bool instantDetectorAttack, bool instantEnvelopeAttack>
+void TransientSplitter<SampleType>::processBlockInternal(juce::AudioBuffer<SampleType> &buffer){
+    auto channels = buffer.getArrayOfWritePointers();
+    const int numChannels = buffer.getNumChannels();
+    const SampleType attackGain = parameter.attack;
+    const SampleType sustainGain = parameter.sustain;
+
+    for (int j = 0; j < buffer.getNumSamples(); j++){
+        const SampleType detectorValue = Envelope<SampleType>::getDetectorValue(channels, numChannels, j);
+
+        const SampleType detected = detector.template processSample<instantDetectorAttack>(detectorValue);
+        const SampleType fast = envelope1.template processSample<true>(detectorValue);
+        const SampleType slow = envelope2.template processSample<instantEnvelopeAttack>(detectorValue);
+
+        const SampleType attack = getAttackAmount(detected, fast, slow);
+        const SampleType gain = attack * attackGain + (1 - attack) * sustainGain;
+
+        for (int i = 0; i < numChannels; i++)
+            channels[i][j] *= gain;
+    }
+}
+
+template <>
+void TransientSplitter<float>::processLanes(TransientSplitter<float>* const* splitters, int numLanes, LaneBuffer &buffer) {
+    constexpr int lanes = LaneBuffer::maxLanes;
+    jassert (numLanes <= lanes);
+
+    // the follower state and coefficients of every lane, unused lanes run with zeros
+    alignas(16) float detected[lanes] {}, fast[lanes] {}, slow[lanes] {};
+    alignas(16) float detectorAttack[lanes] {}, detectorRelease[lanes] {};
+    alignas(16) float fastRelease[lanes] {};
+    alignas(16) float slowAttack[lanes] {}, slowRelease[lanes] {};
+    alignas(16) float attackGain[lanes] {}, sustainGain[lanes] {};
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        const auto& splitter = *splitters[lane];
+        detected[lane] = splitter.detector.getLastValue();
+        fast[lane] = splitter.envelope1.getLastValue();
+        slow[lane] = splitter.envelope2.getLastValue();
+        // an instant attack has a coefficient of zero, so the same follower step covers both attack modes
+        detectorAttack[lane] = splitter.detector.getAttackCoefficient();
+        detectorRelease[lane] = splitter.detector.getReleaseCoefficient();
+        fastRelease[lane] = splitter.envelope1.getReleaseCoefficient();
+        slowAttack[lane] = splitter.envelope2.getAttackCoefficient();
+        slowRelease[lane] = splitter.envelope2.getReleaseCoefficient();
+        attackGain[lane] = splitter.parameter.attack;
+        sustainGain[lane] = splitter.parameter.sustain;
+    }
+
+    auto frames = buffer.getFrames();
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
+        auto& frame = frames[sample].lanes;
+        for (int lane = 0; lane < lanes; ++lane) {
+            const float input = frame[lane];
+
+            const float detectorCoefficient = detected[lane] < input ? detectorAttack[lane] : detectorRelease[lane];
+            detected[lane] = detectorCoefficient * detected[lane] + (1.f - detectorCoefficient) * input;
+            const float fastCoefficient = fast[lane] < input ? 0.f : fastRelease[lane];
+            fast[lane] = fastCoefficient * fast[lane] + (1.f - fastCoefficient) * input;
+            const float slowCoefficient = slow[lane] < input ? slowAttack[lane] : slowRelease[lane];
+            slow[lane] = slowCoefficient * slow[lane] + (1.f - slowCoefficient) * input;
+
+            const float attack = getAttackAmount(detected[lane], fast[lane], slow[lane]);
+            frame[lane] = input * (attack * attackGain[lane] + (1.f - attack) * sustainGain[lane]);
         }
     }
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        auto& splitter = *splitters[lane];
+        splitter.detector.setLastValue(detected[lane]);
+        splitter.envelope1.setLastValue(fast[lane]);
+        splitter.envelope2.setLastValue(slow[lane]);
+    }
 }
 
-void TransientSplitter::setAttack(float newAttack){
+template <typename SampleType>
+SampleType TransientSplitter<SampleType>::getAttackAmount(SampleType detected, SampleType fast, SampleType slow) {
+    // the floor keeps digital silence at the sustain gain instead of 0 / 0
+    return std::min(std::abs(fast - slow) / std::max(std::abs(detected), std::numeric_limits<SampleType>::min()), SampleType(1));
+}
+
+template <typename SampleType>
+void TransientSplitter<SampleType>::setAttack(float newAttack){
     parameter.attack = newAttack;
 }
 
-float TransientSplitter::getAttack() const{
+template <typename SampleType>
+float TransientSplitter<SampleType>::getAttack() const{
     return parameter.attack;
 }
 
-void TransientSplitter::setSustain(float newSustain){
+template <typename SampleType>
+void TransientSplitter<SampleType>::setSustain(float newSustain){
     parameter.sustain = newSustain;
 }
 
-float TransientSplitter::getSustain() const{
+template <typename SampleType>
+float TransientSplitter<SampleType>::getSustain() const{
     return parameter.sustain;
 }
 
-void TransientSplitter::setAttackTime(float newAttackTime){
+template <typename SampleType>
+void TransientSplitter<SampleType>::setAttackTime(float newAttackTime){
     parameter.attackTime = newAttackTime;
     envelope2.setAttackTime(newAttackTime);
 }
 
-float TransientSplitter::getAttackTime() const{
+template <typename SampleType>
+float TransientSplitter<SampleType>::getAttackTime() const{
     return parameter.attackTime;
 }
 
-void TransientSplitter::setAttackTimeDetector(float newAttackTimeDetector){
+template <typename SampleType>
+void TransientSplitter<SampleType>::setAttackTimeDetector(float newAttackTimeDetector){
     parameter.attackTimeDetector = newAttackTimeDetector;
     detector.setAttackTime(newAttackTimeDetector);
 }
 
-float TransientSplitter::getAttackTimeDetector() const{
+template <typename SampleType>
+float TransientSplitter<SampleType>::getAttackTimeDetector() const{
     return parameter.attackTimeDetector;
 }
 
-void TransientSplitter::setReleaseTime(float newReleaseTime){
+template <typename SampleType>
+void TransientSplitter<SampleType>::setReleaseTime(float newReleaseTime){
     parameter.releaseTime = newReleaseTime;
     envelope1.setReleaseTime(newReleaseTime);
     envelope2.setReleaseTime(newReleaseTime);
 }
 
-float TransientSplitter::getReleaseTime() const{
+template <typename SampleType>
+float TransientSplitter<SampleType>::getReleaseTime() const{
     return parameter.releaseTime;
 }
 
-void TransientSplitter::setReleaseTimeRatio(float newReleaseTimeRatio){
+template <typename SampleType>
+void TransientSplitter<SampleType>::setReleaseTimeRatio(float newReleaseTimeRatio){
     parameter.releaseTimeRatio = newReleaseTimeRatio;
     detector.setReleaseTime(parameter.releaseTime * newReleaseTimeRatio);
 }
 
-float TransientSplitter::getReleaseTimeRatio() const{
+template <typename SampleType>
+float TransientSplitter<SampleType>::getReleaseTimeRatio() const{
     return parameter.releaseTimeRatio;
 }
+
+template <typename SampleType>
+size_t TransientSplitter<SampleType>::getSizeInBytes() const {
+    return detector.getSizeInBytes() + envelope1.getSizeInBytes() + envelope2.getSizeInBytes();
+}
+
+template class TransientSplitter<float>;
+template class TransientSplitter<double>;
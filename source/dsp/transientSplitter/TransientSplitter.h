@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "../utils/Envelope.h"
+#include "../utils/LaneBuffer.h"
 
 struct TransientSplitterParameter{
     float attack;
@@ -20,13 +21,20 @@ struct TransientSplitterParameter{
     float releaseTimeRatio;
 };
 
+template <typename SampleType>
 class TransientSplitter{
 public:
     TransientSplitter();
     ~TransientSplitter();
 
     void prepare(const juce::dsp::ProcessSpec &spec);
-    void processBlock(juce::AudioBuffer<float>& buffer);
+    void release();
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
+
+    // processes lane i of the buffer with splitters[i], all lanes in the same pass; the lanes are float only
+    static void processLanes(TransientSplitter* const* splitters, int numLanes, LaneBuffer& buffer);
+
+    size_t getSizeInBytes() const;
 
 public:
     void setAttack(float newAttack);
@@ -47,13 +55,22 @@ public:
     void setReleaseTimeRatio(float newReleaseTimeRatio);
     float getReleaseTimeRatio() const;
 
+private:
+    template <bool instantDetectorAttack, bool instantEnvelopeAttack>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+
+    static SampleType getAttackAmount(SampleType detected, SampleType fast, SampleType slow);
+
 private:
     TransientSplitterParameter parameter {1.f, 1.f, .5f, 0.f, .3f, 10.f};
 
-    Envelope detector;
-    Envelope envelope1;
-    Envelope envelope2;
+    Envelope<SampleType> detector;
+    Envelope<SampleType> envelope1;
+    Envelope<SampleType> envelope2;
     
 };
 
+template <>
+void TransientSplitter<float>::processLanes(TransientSplitter<float>* const* splitters, int numLanes, LaneBuffer& buffer);
+
 #endif /* TransientSplitter_h */
@@ -0,0 +1,72 @@
+#include "CompensationDelay.h"
+#include "MemoryUsage.h"
+
+template <typename SampleType>
+void CompensationDelay<SampleType>::prepare(const juce::dsp::ProcessSpec &spec) {
+    maxDelayInSamples = (int) (maxDelayInSeconds * spec.sampleRate);
+
+    // the block is written before it is read, so the line needs one block of headroom
+    const int delaySize = juce::nextPowerOfTwo(maxDelayInSamples + (int) spec.maximumBlockSize);
+    delayLine.assign((size_t) delaySize, 0);
+    delayMask = delaySize - 1;
+
+    reset();
+}
+
+template <typename SampleType>
+void CompensationDelay<SampleType>::reset() {
+    std::fill(delayLine.begin(), delayLine.end(), (SampleType) 0);
+    writePosition = 0;
+}
+
+template <typename SampleType>
+void CompensationDelay<SampleType>::release() {
+    delayLine = {};
+    delayMask = 0;
+    writePosition = 0;
+    maxDelayInSamples = 0;
+}
+
+template <typename SampleType>
+void CompensationDelay<SampleType>::setDelay(int newDelayInSamples) {
+    jassert (maxDelayInSamples == 0 || newDelayInSamples <= maxDelayInSamples);
+    delayInSamples = juce::jlimit(0, maxDelayInSamples, newDelayInSamples);
+}
+
+template <typename SampleType>
+int CompensationDelay<SampleType>::getDelay() const {
+    return delayInSamples;
+}
+
+template <typename SampleType>
+int CompensationDelay<SampleType>::getMaxDelay() const {
+    return maxDelayInSamples;
+}
+
+template <typename SampleType>
+void CompensationDelay<SampleType>::process(SampleType *data, int numSamples) {
+    jassert (numSamples <= delayMask + 1 - maxDelayInSamples);
+
+    const int delaySize = delayMask + 1;
+    const int firstWrite = juce::jmin(numSamples, delaySize - writePosition);
+    std::copy(data, data + firstWrite, delayLine.begin() + writePosition);
+    std::copy(data + firstWrite, data + numSamples, delayLine.begin());
+
+    // the history is kept up to date even without delay, so a later delay change starts from the real signal
+    if (delayInSamples > 0) {
+        const int readPosition = (writePosition - delayInSamples) & delayMask;
+        const int firstRead = juce::jmin(numSamples, delaySize - readPosition);
+        std::copy(delayLine.begin() + readPosition, delayLine.begin() + readPosition + firstRead, data);
+        std::copy(delayLine.begin(), delayLine.begin() + (numSamples - firstRead), data + firstRead);
+    }
+
+    writePosition = (writePosition + numSamples) & delayMask;
+}
+
+template <typename SampleType>
+size_t CompensationDelay<SampleType>::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(delayLine);
+}
+
+template class CompensationDelay<float>;
+template class CompensationDelay<double>;
@@ -0,0 +1,33 @@
+#ifndef compensationdelay_h
+#define compensationdelay_h
+
+#include <JuceHeader.h>
+
+/*  Fixed integer delay for aligning a mono branch to the latency of the slowest branch.
+ *  The line is allocated in prepare for the largest delay, so the delay itself can change while processing is
+ *  suspended without allocating. A delay of zero passes the signal through.
+ */
+template <typename SampleType>
+class CompensationDelay {
+public:
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    void release();
+    void setDelay(int newDelayInSamples);
+    int getDelay() const;
+    int getMaxDelay() const;
+    size_t getSizeInBytes() const;
+
+    void process(SampleType* data, int numSamples);
+
+private:
+    std::vector<SampleType> delayLine;
+    int delayMask = 0;
+    int writePosition = 0;
+    int delayInSamples = 0;
+    int maxDelayInSamples = 0;
+
+    static constexpr double maxDelayInSeconds = 1.;
+};
+
+#endif
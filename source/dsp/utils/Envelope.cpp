@@ -6,73 +6,125 @@
 //
 
 #include "Envelope.h"
+#include "MemoryUsage.h"
 
-Envelope::Envelope(float initAttackTime, float initReleaseTime) {
+template <typename SampleType>
+Envelope<SampleType>::Envelope(float initAttackTime, float initReleaseTime) {
     attackTime = initAttackTime;
     releaseTime = initReleaseTime;
 }
 
-Envelope::~Envelope() = default;
+template <typename SampleType>
+Envelope<SampleType>::~Envelope() = default;
 
-void Envelope::prepare(const juce::dsp::ProcessSpec &spec){
+template <typename SampleType>
+void Envelope<SampleType>::prepare(const juce::dsp::ProcessSpec &spec){
     setSampleRate((float) spec.sampleRate);
     setAttackTime(getAttackTime());
     setReleaseTime(getReleaseTime());
-    for (int i = 0; i < (int) spec.maximumBlockSize; i++){
-        envelope.push_back(0.);
-        detector.push_back(0.);
-    }
-}
-
-void Envelope::processBlock(juce::AudioBuffer<float>& buffer){
-    bool mono = (buffer.getNumChannels() == 1);
-    if (attackTime == 0.f){
-        for (unsigned long i = 0; i < (unsigned long) buffer.getNumSamples(); i++){
-            detector[i] = (mono) ? buffer.getSample(0, (int) i)
-                           : std::max(std::abs(buffer.getSample(0, (int) i)), std::abs(buffer.getSample(1, (int) i)));
-            if (lastValue < detector[i]) envelope[i] = detector[i];
-            else envelope[i] = releaseCoefficient*lastValue + (1-releaseCoefficient)*detector[i];
-            lastValue = envelope[i];
-        }
-    }
-    else {
-        for (unsigned long i = 0; i < (unsigned long) buffer.getNumSamples(); i++){
-            detector[i] = (mono) ? buffer.getSample(0, (int) i)
-                            : std::max(std::abs(buffer.getSample(0, (int) i)), std::abs(buffer.getSample(1, (int) i)));
-            if (isnan(lastValue)) lastValue = 0.f;
-            if (lastValue < detector[i]) envelope[i] = attackCoefficient*lastValue + (1-attackCoefficient)*detector[i];
-            else envelope[i] = releaseCoefficient*lastValue + (1-releaseCoefficient)*detector[i];
-            lastValue = envelope[i];
-        }
-    }
-}
-
-void Envelope::setAttackTime(float newAttackTime){
+    envelope.assign(spec.maximumBlockSize, SampleType(0));
+}
+
+template <typename SampleType>
+void Envelope<SampleType>::release(){
+    envelope = {};
+    lastValue = 0;
+}
+
+template <typename SampleType>
+void Envelope<SampleType>::processBlock(juce::AudioBuffer<SampleType>& buffer){
+    if (hasInstantAttack()) processBlockInternal<true>(buffer);
+    else processBlockInternal<false>(buffer);
+}
+
+template <typename SampleType>
+template <bool instantAttack>
+void Envelope<SampleType>::processBlockInternal(juce::AudioBuffer<SampleType>& buffer){
+    auto channels = buffer.getArrayOfReadPointers();
+    const int numChannels = buffer.getNumChannels();
+
+    for (int i = 0; i < buffer.getNumSamples(); i++)
+        envelope[(size_t) i] = processSample<instantAttack>(getDetectorValue(channels, numChannels, i));
+}
+
+template <typename SampleType>
+bool Envelope<SampleType>::hasInstantAttack() const {
+    return attackTime == 0.f;
+}
+
+template <typename SampleType>
+SampleType Envelope<SampleType>::getDetectorValue(const SampleType* const* channels, int numChannels, int sample) {
+    // mono input is followed as is, stereo input by the louder channel
+    if (numChannels == 1) return channels[0][sample];
+    return std::max(std::abs(channels[0][sample]), std::abs(channels[1][sample]));
+}
+
+template <typename SampleType>
+void Envelope<SampleType>::setAttackTime(float newAttackTime){
     attackTime = newAttackTime;
     attackCoefficient = (float) std::exp(-1/(newAttackTime*getSampleRate()));
 }
 
-float Envelope::getAttackTime() const{
+template <typename SampleType>
+float Envelope<SampleType>::getAttackTime() const{
     return attackTime;
 }
 
-void Envelope::setReleaseTime(float newReleaseTime){
+template <typename SampleType>
+void Envelope<SampleType>::setReleaseTime(float newReleaseTime){
     releaseTime = newReleaseTime;
     releaseCoefficient = (float) std::exp(-1/(newReleaseTime*getSampleRate()));
 }
 
-float Envelope::getReleaseTime() const{
+template <typename SampleType>
+float Envelope<SampleType>::getReleaseTime() const{
     return releaseTime;
 }
 
-float Envelope::getSample(unsigned long sample){
+template <typename SampleType>
+float Envelope<SampleType>::getAttackCoefficient() const {
+    return attackCoefficient;
+}
+
+template <typename SampleType>
+float Envelope<SampleType>::getReleaseCoefficient() const {
+    return releaseCoefficient;
+}
+
+template <typename SampleType>
+SampleType Envelope<SampleType>::getLastValue() const {
+    return lastValue;
+}
+
+template <typename SampleType>
+void Envelope<SampleType>::setLastValue(SampleType newLastValue) {
+    lastValue = newLastValue;
+}
+
+template <typename SampleType>
+SampleType Envelope<SampleType>::getSample(unsigned long sample){
     return envelope[sample];
 }
 
-void Envelope::setSampleRate(float newSampleRate) {
+template <typename SampleType>
+const SampleType* Envelope<SampleType>::getReadPointer() const {
+    return envelope.data();
+}
+
+template <typename SampleType>
+void Envelope<SampleType>::setSampleRate(float newSampleRate) {
     sampleRate = newSampleRate;
 }
 
-float Envelope::getSampleRate() const {
+template <typename SampleType>
+float Envelope<SampleType>::getSampleRate() const {
     return sampleRate;
 }
+
+template <typename SampleType>
+size_t Envelope<SampleType>::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(envelope);
+}
+
+template class Envelope<float>;
+template class Envelope<double>;
@@ -10,26 +10,57 @@
 
 #include <JuceHeader.h>
 
+// the follower runs at the sample type of the signal it follows, times and coefficients stay float
+template <typename SampleType>
 class Envelope{
 public:
     Envelope(float initAttackTime, float initReleaseTime);
     ~Envelope();
     void prepare(const juce::dsp::ProcessSpec &spec);
+    void release();
     void setAttackTime(float attackTime);
     float getAttackTime() const;
     void setReleaseTime(float releaseTime);
     float getReleaseTime() const;
-    void processBlock(juce::AudioBuffer<float>& buffer);
-    float getSample(unsigned long sample);
+    void processBlock(juce::AudioBuffer<SampleType>& buffer);
+    SampleType getSample(unsigned long sample);
+    const SampleType* getReadPointer() const;
+    size_t getSizeInBytes() const;
+
+    bool hasInstantAttack() const;
+    static SampleType getDetectorValue(const SampleType* const* channels, int numChannels, int sample);
+
+    // single step of the follower, for callers that fuse several envelopes into one pass
+    template <bool instantAttack>
+    SampleType processSample(SampleType detectorValue) {
+        SampleType value;
+        if constexpr (instantAttack) {
+            if (lastValue < detectorValue) value = detectorValue;
+            else value = releaseCoefficient*lastValue + (1-releaseCoefficient)*detectorValue;
+        } else {
+            if (lastValue < detectorValue) value = attackCoefficient*lastValue + (1-attackCoefficient)*detectorValue;
+            else value = releaseCoefficient*lastValue + (1-releaseCoefficient)*detectorValue;
+        }
+        lastValue = value;
+        return value;
+    }
+
+    // follower state, for callers that run several envelopes side by side
+    float getAttackCoefficient() const;
+    float getReleaseCoefficient() const;
+    SampleType getLastValue() const;
+    void setLastValue(SampleType newLastValue);
 
 private:
     void setSampleRate(float newSampleRate);
     float getSampleRate() const;
 
+    template <bool instantAttack>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+
 private:
-    std::vector<float> envelope;
-    float lastValue = 0.f;
-    std::vector<float> detector;
+    std::vector<SampleType> envelope;
+    SampleType lastValue = 0;
     float attackTime;
     float releaseTime;
     float attackCoefficient = 1.f;
@@ -0,0 +1,147 @@
+#include "EventLog.h"
+
+EventLog::EventLog() : startTicks(juce::Time::getHighResolutionTicks()), startTime(juce::Time::getCurrentTime()) {
+    for (size_t i = 0; i < slots.size(); ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool EventLog::log(DiagnosticEvent::Type type, int source, juce::int64 value0, juce::int64 value1, const char *message) {
+    // a slot is free for position p when its sequence is p, and holds an event for the reader when it is p + 1
+    auto position = writePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots[position % (size_t) capacity];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) position;
+
+        if (difference == 0) {
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    auto& event = slot->event;
+    event.type = type;
+    event.source = source;
+    event.ticks = juce::Time::getHighResolutionTicks();
+    event.values[0] = value0;
+    event.values[1] = value1;
+    event.message[0] = 0;
+    if (message != nullptr) {
+        std::strncpy(event.message, message, sizeof(event.message) - 1);
+        event.message[sizeof(event.message) - 1] = 0;
+    }
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventLog::pop(DiagnosticEvent &event) {
+    auto& slot = slots[readPosition % (size_t) capacity];
+    if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1)
+        return false;
+
+    event = slot.event;
+    slot.sequence.store(readPosition + (size_t) capacity, std::memory_order_release);
+    ++readPosition;
+    return true;
+}
+
+int EventLog::getNumDroppedEvents() const {
+    return droppedEvents.load(std::memory_order_relaxed);
+}
+
+juce::String EventLog::describe(const DiagnosticEvent &event) const {
+    const auto time = startTime + juce::RelativeTime::seconds(juce::Time::highResolutionTicksToSeconds(event.ticks - startTicks));
+    const auto source = event.source == 0 ? juce::String("processor") : "network " + juce::String(event.source);
+    const juce::String message(event.message);
+
+    juce::String text;
+    switch (event.type) {
+        case DiagnosticEvent::Type::underrun:
+            text = "underrun " + juce::String(event.values[0]) + ", target lag " + juce::String(event.values[1]) + " samples";
+            break;
+        case DiagnosticEvent::Type::samplesRepaired:
+            text = "repaired " + juce::String(event.values[0]) + " non-finite and " + juce::String(event.values[1])
+                   + " denormal samples at the " + message;
+            break;
+        case DiagnosticEvent::Type::modelLoaded:
+            text = "loaded model " + message + " (" + juce::File::descriptionOfSizeInBytes(event.values[0]) + ")";
+            break;
+        case DiagnosticEvent::Type::deadlineMissed:
+            text = "inference took " + juce::String(event.values[0]) + " us, budget " + juce::String(event.values[1]) + " us";
+            break;
+        case DiagnosticEvent::Type::inferenceException:
+            text = "inference failed: " + message;
+            break;
+    }
+
+    return time.toISO8601(true) + " " + source + ": " + text;
+}
+
+namespace {
+    std::atomic<int> numEventLogWriters {0};
+}
+
+EventLogWriter::EventLogWriter(EventLog &log) : juce::Thread("Scyclone event log"),
+                                                eventLog(log),
+                                                instanceNumber(++numEventLogWriters) {}
+
+EventLogWriter::~EventLogWriter() {
+    stop();
+}
+
+void EventLogWriter::start() {
+    if (isThreadRunning()) return;
+    startThread(juce::Thread::Priority::low);
+}
+
+void EventLogWriter::stop() {
+    stopThread(1000);
+    // whatever was logged after the last pass
+    drain();
+}
+
+juce::StringArray EventLogWriter::getRecentLines() const {
+    const juce::ScopedLock lock(recentLinesLock);
+    return recentLines;
+}
+
+void EventLogWriter::run() {
+    while (!threadShouldExit()) {
+        drain();
+        wait(drainIntervalInMs);
+    }
+}
+
+void EventLogWriter::drain() {
+    juce::StringArray lines;
+    DiagnosticEvent event;
+    while (eventLog.pop(event))
+        lines.add("[" + juce::String(instanceNumber) + "] " + eventLog.describe(event));
+
+    const int droppedEvents = eventLog.getNumDroppedEvents();
+    if (droppedEvents != reportedDroppedEvents) {
+        lines.add("[" + juce::String(instanceNumber) + "] " + juce::String(droppedEvents - reportedDroppedEvents)
+                  + " events dropped, the log was full");
+        reportedDroppedEvents = droppedEvents;
+    }
+
+    if (lines.isEmpty()) return;
+
+    if (fileLogger == nullptr)
+        fileLogger.reset(juce::FileLogger::createDefaultAppLogger("Scyclone", "Scyclone.log", "Scyclone diagnostic events"));
+
+    for (const auto& line : lines)
+        fileLogger->logMessage(line);
+
+    const juce::ScopedLock lock(recentLinesLock);
+    recentLines.addArray(lines);
+    if (recentLines.size() > maxRecentLines)
+        recentLines.removeRange(0, recentLines.size() - maxRecentLines);
+}
@@ -0,0 +1,93 @@
+#ifndef eventlog_h
+#define eventlog_h
+
+#include <JuceHeader.h>
+
+struct DiagnosticEvent {
+    enum class Type {
+        underrun,           // values: underruns so far, target lag in samples
+        samplesRepaired,    // values: non-finite samples, denormal samples; message: where
+        modelLoaded,        // values: model size in bytes; message: model name
+        deadlineMissed,     // values: inference time in us, budget in us
+        inferenceException  // message: exception text
+    };
+
+    Type type = Type::underrun;
+    // network number, 0 for the processor itself
+    int source = 0;
+    juce::int64 ticks = 0;
+    juce::int64 values[2] {};
+    char message[48] {};
+};
+
+/*  Fixed-capacity log for events that happen on the audio and inference threads.
+ *  Logging copies the event into a preallocated slot and claims it with one compare-and-swap, so any thread may log
+ *  without locking or allocating. When the log is full the event is dropped and counted. A single reader, usually
+ *  the EventLogWriter, takes them out in order.
+ */
+class EventLog {
+public:
+    EventLog();
+
+    bool log(DiagnosticEvent::Type type, int source, juce::int64 value0 = 0, juce::int64 value1 = 0,
+             const char* message = nullptr);
+
+    // reader side, one thread only
+    bool pop(DiagnosticEvent& event);
+    int getNumDroppedEvents() const;
+
+    // one line with the wall-clock time of the event
+    juce::String describe(const DiagnosticEvent& event) const;
+
+    static constexpr int capacity = 1024;
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence {0};
+        DiagnosticEvent event;
+    };
+
+    std::array<Slot, capacity> slots;
+    std::atomic<size_t> writePosition {0};
+    size_t readPosition = 0;
+    std::atomic<int> droppedEvents {0};
+
+    const juce::int64 startTicks;
+    const juce::Time startTime;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLog)
+};
+
+/*  Background drain of an EventLog. Every few hundred milliseconds it takes out the pending events, appends them to
+ *  the log file and keeps the latest lines for the editor. The file is only created when the first event arrives.
+ */
+class EventLogWriter : private juce::Thread {
+public:
+    explicit EventLogWriter(EventLog& log);
+    ~EventLogWriter() override;
+
+    // message thread
+    void start();
+    void stop();
+
+    juce::StringArray getRecentLines() const;
+
+private:
+    void run() override;
+    void drain();
+
+    EventLog& eventLog;
+    std::unique_ptr<juce::FileLogger> fileLogger;
+    const int instanceNumber;
+    int reportedDroppedEvents = 0;
+
+    juce::CriticalSection recentLinesLock;
+    juce::StringArray recentLines;
+
+    static constexpr int drainIntervalInMs = 250;
+    static constexpr int maxRecentLines = 32;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLogWriter)
+};
+
+#endif
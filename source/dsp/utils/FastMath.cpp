@@ -0,0 +1,206 @@
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined (__AVX2__)
+ #include <immintrin.h>
+ #define SCYCLONE_FAST_MATH_AVX2 1
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SCYCLONE_FAST_MATH_SSE2 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define SCYCLONE_FAST_MATH_NEON 1
+#endif
+
+namespace {
+    // log2(1 + t) = t * q(t) for t in [0, 1), lowest order first
+    constexpr float log2Coefficients[] = { 1.44266783f, -0.720585468f, 0.473553406f, -0.325901958f,
+                                           0.194294298f, -0.0795577124f, 0.0155299119f };
+
+    // exp2(f) = 1 + f * r(f) for f in [0, 1), lowest order first
+    constexpr float exp2Coefficients[] = { 0.693147004f, 0.240229899f, 0.0554824864f, 0.00968116938f,
+                                           0.00124149238f, 0.000217946589f };
+
+    constexpr float minExp2Input = -126.f;
+    constexpr float maxExp2Input = 127.f;
+
+    constexpr int mantissaBits = 23;
+    constexpr std::uint32_t mantissaMask = 0x007fffff;
+    constexpr std::uint32_t exponentOfOne = 0x3f800000;
+    constexpr int exponentBias = 127;
+
+    float log2Scalar(float x) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        const auto exponent = (float) ((int) ((bits >> mantissaBits) & 0xff) - exponentBias);
+
+        bits = (bits & mantissaMask) | exponentOfOne;
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        const float t = mantissa - 1.f;
+        float polynomial = log2Coefficients[6];
+        for (int i = 5; i >= 0; --i)
+            polynomial = polynomial * t + log2Coefficients[i];
+        return exponent + t * polynomial;
+    }
+
+    float exp2Scalar(float x) {
+        x = std::min(std::max(x, minExp2Input), maxExp2Input);
+        const float whole = std::floor(x);
+        const float f = x - whole;
+
+        float polynomial = exp2Coefficients[5];
+        for (int i = 4; i >= 0; --i)
+            polynomial = polynomial * f + exp2Coefficients[i];
+
+        const auto scaleBits = (std::uint32_t) ((int) whole + exponentBias) << mantissaBits;
+        float scale;
+        std::memcpy(&scale, &scaleBits, sizeof(scale));
+        return (1.f + f * polynomial) * scale;
+    }
+
+#if SCYCLONE_FAST_MATH_AVX2
+    constexpr int vectorSize = 8;
+
+    void log2Vector(const float* input, float* output) {
+        const __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(input));
+        const __m256i exponentBits = _mm256_and_si256(_mm256_srli_epi32(bits, mantissaBits), _mm256_set1_epi32(0xff));
+        const __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(exponentBits, _mm256_set1_epi32(exponentBias)));
+
+        const __m256i mantissaBitsOnly = _mm256_and_si256(bits, _mm256_set1_epi32((int) mantissaMask));
+        const __m256 mantissa = _mm256_castsi256_ps(_mm256_or_si256(mantissaBitsOnly, _mm256_set1_epi32((int) exponentOfOne)));
+        const __m256 t = _mm256_sub_ps(mantissa, _mm256_set1_ps(1.f));
+
+        __m256 polynomial = _mm256_set1_ps(log2Coefficients[6]);
+        for (int i = 5; i >= 0; --i)
+            polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, t), _mm256_set1_ps(log2Coefficients[i]));
+        _mm256_storeu_ps(output, _mm256_add_ps(exponent, _mm256_mul_ps(t, polynomial)));
+    }
+
+    void exp2Vector(const float* input, float* output) {
+        __m256 x = _mm256_loadu_ps(input);
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(minExp2Input)), _mm256_set1_ps(maxExp2Input));
+        const __m256 whole = _mm256_floor_ps(x);
+        const __m256 f = _mm256_sub_ps(x, whole);
+
+        __m256 polynomial = _mm256_set1_ps(exp2Coefficients[5]);
+        for (int i = 4; i >= 0; --i)
+            polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, f), _mm256_set1_ps(exp2Coefficients[i]));
+
+        const __m256i scaleBits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(whole), _mm256_set1_epi32(exponentBias)), mantissaBits);
+        const __m256 result = _mm256_add_ps(_mm256_set1_ps(1.f), _mm256_mul_ps(f, polynomial));
+        _mm256_storeu_ps(output, _mm256_mul_ps(result, _mm256_castsi256_ps(scaleBits)));
+    }
+#elif SCYCLONE_FAST_MATH_SSE2
+    constexpr int vectorSize = 4;
+
+    void log2Vector(const float* input, float* output) {
+        const __m128i bits = _mm_castps_si128(_mm_loadu_ps(input));
+        const __m128i exponentBits = _mm_and_si128(_mm_srli_epi32(bits, mantissaBits), _mm_set1_epi32(0xff));
+        const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(exponentBits, _mm_set1_epi32(exponentBias)));
+
+        const __m128i mantissaBitsOnly = _mm_and_si128(bits, _mm_set1_epi32((int) mantissaMask));
+        const __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(mantissaBitsOnly, _mm_set1_epi32((int) exponentOfOne)));
+        const __m128 t = _mm_sub_ps(mantissa, _mm_set1_ps(1.f));
+
+        __m128 polynomial = _mm_set1_ps(log2Coefficients[6]);
+        for (int i = 5; i >= 0; --i)
+            polynomial = _mm_add_ps(_mm_mul_ps(polynomial, t), _mm_set1_ps(log2Coefficients[i]));
+        _mm_storeu_ps(output, _mm_add_ps(exponent, _mm_mul_ps(t, polynomial)));
+    }
+
+    void exp2Vector(const float* input, float* output) {
+        __m128 x = _mm_loadu_ps(input);
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(minExp2Input)), _mm_set1_ps(maxExp2Input));
+
+        // SSE2 has no floor: truncate and step down where truncation rounded a negative value up
+        const __m128i truncated = _mm_cvttps_epi32(x);
+        const __m128 roundedUp = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), x);
+        const __m128i wholeBits = _mm_add_epi32(truncated, _mm_castps_si128(roundedUp));
+        const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(wholeBits));
+
+        __m128 polynomial = _mm_set1_ps(exp2Coefficients[5]);
+        for (int i = 4; i >= 0; --i)
+            polynomial = _mm_add_ps(_mm_mul_ps(polynomial, f), _mm_set1_ps(exp2Coefficients[i]));
+
+        const __m128i scaleBits = _mm_slli_epi32(_mm_add_epi32(wholeBits, _mm_set1_epi32(exponentBias)), mantissaBits);
+        const __m128 result = _mm_add_ps(_mm_set1_ps(1.f), _mm_mul_ps(f, polynomial));
+        _mm_storeu_ps(output, _mm_mul_ps(result, _mm_castsi128_ps(scaleBits)));
+    }
+#elif SCYCLONE_FAST_MATH_NEON
+    constexpr int vectorSize = 4;
+
+    void log2Vector(const float* input, float* output) {
+        const uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(input));
+        const int32x4_t exponentBits = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(bits, mantissaBits), vdupq_n_u32(0xff)));
+        const float32x4_t exponent = vcvtq_f32_s32(vsubq_s32(exponentBits, vdupq_n_s32(exponentBias)));
+
+        const uint32x4_t mantissaBitsOnly = vandq_u32(bits, vdupq_n_u32(mantissaMask));
+        const float32x4_t mantissa = vreinterpretq_f32_u32(vorrq_u32(mantissaBitsOnly, vdupq_n_u32(exponentOfOne)));
+        const float32x4_t t = vsubq_f32(mantissa, vdupq_n_f32(1.f));
+
+        float32x4_t polynomial = vdupq_n_f32(log2Coefficients[6]);
+        for (int i = 5; i >= 0; --i)
+            polynomial = vaddq_f32(vmulq_f32(polynomial, t), vdupq_n_f32(log2Coefficients[i]));
+        vst1q_f32(output, vaddq_f32(exponent, vmulq_f32(t, polynomial)));
+    }
+
+    void exp2Vector(const float* input, float* output) {
+        float32x4_t x = vld1q_f32(input);
+        x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(minExp2Input)), vdupq_n_f32(maxExp2Input));
+
+        // truncate and step down where truncation rounded a negative value up
+        const int32x4_t truncated = vcvtq_s32_f32(x);
+        const uint32x4_t roundedUp = vcgtq_f32(vcvtq_f32_s32(truncated), x);
+        const int32x4_t wholeBits = vaddq_s32(truncated, vreinterpretq_s32_u32(roundedUp));
+        const float32x4_t f = vsubq_f32(x, vcvtq_f32_s32(wholeBits));
+
+        float32x4_t polynomial = vdupq_n_f32(exp2Coefficients[5]);
+        for (int i = 4; i >= 0; --i)
+            polynomial = vaddq_f32(vmulq_f32(polynomial, f), vdupq_n_f32(exp2Coefficients[i]));
+
+        const int32x4_t scaleBits = vshlq_n_s32(vaddq_s32(wholeBits, vdupq_n_s32(exponentBias)), mantissaBits);
+        const float32x4_t result = vaddq_f32(vdupq_n_f32(1.f), vmulq_f32(f, polynomial));
+        vst1q_f32(output, vmulq_f32(result, vreinterpretq_f32_s32(scaleBits)));
+    }
+#else
+    constexpr int vectorSize = 1;
+
+    void log2Vector(const float* input, float* output) {
+        *output = log2Scalar(*input);
+    }
+
+    void exp2Vector(const float* input, float* output) {
+        *output = exp2Scalar(*input);
+    }
+#endif
+}
+
+void utils::fastLog2(const float *input, float *output, int numSamples) {
+    int sample = 0;
+    for (; sample + vectorSize <= numSamples; sample += vectorSize)
+        log2Vector(input + sample, output + sample);
+    for (; sample < numSamples; ++sample)
+        output[sample] = log2Scalar(input[sample]);
+}
+
+void utils::fastExp2(const float *input, float *output, int numSamples) {
+    int sample = 0;
+    for (; sample + vectorSize <= numSamples; sample += vectorSize)
+        exp2Vector(input + sample, output + sample);
+    for (; sample < numSamples; ++sample)
+        output[sample] = exp2Scalar(input[sample]);
+}
+
+float utils::fastLog2(float x) {
+    return log2Scalar(x);
+}
+
+float utils::fastExp2(float x) {
+    return exp2Scalar(x);
+}
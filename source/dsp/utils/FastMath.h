@@ -0,0 +1,23 @@
+#ifndef fastmath_h
+#define fastmath_h
+
+/*  Block-wise log2 and exp2 approximations for the dB conversions of the signal chain.
+ *  Both split the float into exponent and mantissa through its bits and evaluate a minimax polynomial on the
+ *  mantissa. A block runs 8 values per step with AVX2, 4 with SSE2 or NEON and the remainder in scalar code, all
+ *  with the same polynomials, whichever of these the build targets.
+ *  The choice is made at compile time, there is no runtime dispatch: a default x86-64 build only assumes SSE2 and
+ *  takes that path on every machine, the AVX2 one needs e.g. -mavx2 or /arch:AVX2 for the plugin target.
+ *
+ *  Measured against the double precision functions over the whole input range (benchmarks/FastMathBenchmark.cpp):
+ *      log2(x), x positive and normal:      absolute error < 5e-6, about 3e-5 dB (zero and denormals give -127)
+ *      exp2(x), x clamped to [-126, 127]:    relative error < 1e-7
+ */
+namespace utils {
+    void fastLog2(const float* input, float* output, int numSamples);
+    void fastExp2(const float* input, float* output, int numSamples);
+
+    float fastLog2(float x);
+    float fastExp2(float x);
+}
+
+#endif
@@ -0,0 +1,33 @@
+#include "LaneBuffer.h"
+#include "MemoryUsage.h"
+
+void LaneBuffer::prepare(int maxBlockSize) {
+    frames.assign((size_t) juce::jmax(1, maxBlockSize), Frame {});
+    numSamples = 0;
+}
+
+void LaneBuffer::broadcast(const float *source, int newNumSamples) {
+    jassert (newNumSamples <= (int) frames.size());
+    numSamples = newNumSamples;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+        for (auto& lane : frames[(size_t) sample].lanes)
+            lane = source[sample];
+}
+
+void LaneBuffer::copyLaneTo(int lane, float *destination) const {
+    for (int sample = 0; sample < numSamples; ++sample)
+        destination[sample] = frames[(size_t) sample].lanes[lane];
+}
+
+LaneBuffer::Frame *LaneBuffer::getFrames() {
+    return frames.data();
+}
+
+int LaneBuffer::getNumSamples() const {
+    return numSamples;
+}
+
+size_t LaneBuffer::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(frames);
+}
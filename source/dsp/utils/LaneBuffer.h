@@ -0,0 +1,32 @@
+#ifndef lanebuffer_h
+#define lanebuffer_h
+
+#include <JuceHeader.h>
+
+/*  Interleaved buffer for processing up to maxLanes mono signals side by side.
+ *  The lanes of one sample form an aligned frame, so a recursion that cannot be vectorised along time can still run
+ *  all lanes in one vector register. Unused lanes are carried along and ignored.
+ */
+class LaneBuffer {
+public:
+    static constexpr int maxLanes = 4;
+
+    struct alignas(16) Frame {
+        float lanes[maxLanes];
+    };
+
+    void prepare(int maxBlockSize);
+
+    void broadcast(const float* source, int numSamples);
+    void copyLaneTo(int lane, float* destination) const;
+
+    Frame* getFrames();
+    int getNumSamples() const;
+    size_t getSizeInBytes() const;
+
+private:
+    std::vector<Frame> frames;
+    int numSamples = 0;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "MemoryUsage.h"
+
+MemoryUsage::MemoryUsage(juce::String name, size_t sizeInBytes) : name(std::move(name)), ownSizeInBytes(sizeInBytes) {
+}
+
+void MemoryUsage::add(const juce::String &entryName, size_t entrySizeInBytes) {
+    children.emplace_back(entryName, entrySizeInBytes);
+}
+
+MemoryUsage& MemoryUsage::addChild(const juce::String &entryName) {
+    children.emplace_back(entryName);
+    return children.back();
+}
+
+const juce::String& MemoryUsage::getName() const {
+    return name;
+}
+
+size_t MemoryUsage::getSizeInBytes() const {
+    size_t total = ownSizeInBytes;
+    for (const auto& child : children)
+        total += child.getSizeInBytes();
+    return total;
+}
+
+const std::vector<MemoryUsage>& MemoryUsage::getChildren() const {
+    return children;
+}
+
+juce::var MemoryUsage::toVar() const {
+    auto object = new juce::DynamicObject();
+    object->setProperty("name", name);
+    object->setProperty("bytes", (juce::int64) getSizeInBytes());
+
+    if (! children.empty()) {
+        juce::Array<juce::var> childVars;
+        for (const auto& child : children)
+            childVars.add(child.toVar());
+        object->setProperty("children", childVars);
+    }
+
+    return juce::var(object);
+}
+
+juce::String MemoryUsage::toJSON() const {
+    return juce::JSON::toString(toVar());
+}
+
+juce::StringArray MemoryUsage::toLines() const {
+    juce::StringArray lines;
+    appendLines(lines, 0);
+    return lines;
+}
+
+size_t MemoryUsage::getSizeInBytes(const juce::AudioBuffer<float> &buffer) {
+    return (size_t) buffer.getNumChannels() * (size_t) buffer.getNumSamples() * sizeof(float);
+}
+
+void MemoryUsage::appendLines(juce::StringArray &lines, int depth) const {
+    lines.add(juce::String::repeatedString("  ", depth) + name + ": "
+              + juce::File::descriptionOfSizeInBytes((juce::int64) getSizeInBytes()));
+
+    for (const auto& child : children)
+        child.appendLines(lines, depth + 1);
+}
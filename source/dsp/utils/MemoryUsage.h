@@ -0,0 +1,44 @@
+#ifndef memoryusage_h
+#define memoryusage_h
+
+#include <JuceHeader.h>
+
+/*  Breakdown of the memory one plugin instance holds, as a tree of named entries.
+ *  Subsystems with a single allocation report it through getSizeInBytes, composites add one entry per part in
+ *  addMemoryUsage. Sizes are what is allocated, not what is in use. Collect it on the message thread, the audio
+ *  thread never reallocates so reading the sizes there is safe.
+ */
+class MemoryUsage {
+public:
+    explicit MemoryUsage(juce::String name = {}, size_t sizeInBytes = 0);
+
+    void add(const juce::String& entryName, size_t entrySizeInBytes);
+    // the returned entry is only valid until the next entry is added to this one
+    MemoryUsage& addChild(const juce::String& entryName);
+
+    const juce::String& getName() const;
+    // the entry itself and everything below it
+    size_t getSizeInBytes() const;
+    const std::vector<MemoryUsage>& getChildren() const;
+
+    juce::var toVar() const;
+    juce::String toJSON() const;
+    // one indented line per entry, for the diagnostics view
+    juce::StringArray toLines() const;
+
+    template <typename T>
+    static size_t getSizeInBytes(const std::vector<T>& vector) {
+        return vector.capacity() * sizeof(T);
+    }
+
+    static size_t getSizeInBytes(const juce::AudioBuffer<float>& buffer);
+
+private:
+    void appendLines(juce::StringArray& lines, int depth) const;
+
+    juce::String name;
+    size_t ownSizeInBytes = 0;
+    std::vector<MemoryUsage> children;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef perprecision_h
+#define perprecision_h
+
+#include <JuceHeader.h>
+
+/*  One instance of a stage template for each sample type the host can process in. The host picks the precision
+ *  before prepareToPlay, so only the matching instance is prepared and gets memory, the other one is released and
+ *  only keeps its parameters.
+ */
+template <template <typename> class Stage>
+class PerPrecision {
+public:
+    template <typename... Args>
+    explicit PerPrecision(Args&... args) : singlePrecision(args...), doublePrecision(args...) {}
+
+    template <typename SampleType>
+    Stage<SampleType>& get() {
+        if constexpr (std::is_same_v<SampleType, double>) return doublePrecision;
+        else return singlePrecision;
+    }
+
+    template <typename SampleType>
+    const Stage<SampleType>& get() const {
+        if constexpr (std::is_same_v<SampleType, double>) return doublePrecision;
+        else return singlePrecision;
+    }
+
+    template <typename Function>
+    void forEach(Function&& function) {
+        function(singlePrecision);
+        function(doublePrecision);
+    }
+
+    template <typename Function>
+    void forEach(Function&& function) const {
+        function(singlePrecision);
+        function(doublePrecision);
+    }
+
+    template <typename... Args>
+    void prepare(juce::AudioProcessor::ProcessingPrecision precision, const Args&... args) {
+        if (precision == juce::AudioProcessor::doublePrecision) {
+            singlePrecision.release();
+            doublePrecision.prepare(args...);
+        } else {
+            doublePrecision.release();
+            singlePrecision.prepare(args...);
+        }
+    }
+
+    size_t getSizeInBytes() const {
+        return singlePrecision.getSizeInBytes() + doublePrecision.getSizeInBytes();
+    }
+
+private:
+    Stage<float> singlePrecision;
+    Stage<double> doublePrecision;
+};
+
+#endif
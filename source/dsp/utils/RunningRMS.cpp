@@ -0,0 +1,74 @@
+#include "RunningRMS.h"
+#include "MemoryUsage.h"
+#include <numeric>
+
+RunningRMS::RunningRMS() = default;
+
+RunningRMS::~RunningRMS() = default;
+
+void RunningRMS::prepare(int windowSizeInSamples) {
+    const int numChunks = juce::jmax(2, windowSizeInSamples / chunkSize);
+    chunkSums.assign((size_t) numChunks, 0.);
+    reset();
+}
+
+void RunningRMS::reset() {
+    std::fill(chunkSums.begin(), chunkSums.end(), 0.);
+    runningSum = 0.;
+    currentChunk = 0;
+    samplesInChunk = 0;
+    chunksSinceRecompute = 0;
+}
+
+void RunningRMS::release() {
+    chunkSums = {};
+    reset();
+}
+
+template <typename SampleType>
+void RunningRMS::pushSamples(const SampleType *data, int numSamples) {
+    int sample = 0;
+    while (sample < numSamples) {
+        const int samplesToAdd = juce::jmin(numSamples - sample, chunkSize - samplesInChunk);
+
+        double sum = 0.;
+        for (int i = 0; i < samplesToAdd; ++i)
+            sum += (double) data[sample + i] * (double) data[sample + i];
+
+        chunkSums[currentChunk] += sum;
+        runningSum += sum;
+        samplesInChunk += samplesToAdd;
+        sample += samplesToAdd;
+
+        if (samplesInChunk == chunkSize)
+            startNextChunk();
+    }
+}
+
+float RunningRMS::getRMSLevel() const {
+    if (chunkSums.empty()) return 0.f;
+
+    // the current chunk is partially filled, every other chunk covers chunkSize samples
+    const auto windowSize = (double) ((int) (chunkSums.size() - 1) * chunkSize + samplesInChunk);
+    return (float) std::sqrt(juce::jmax(0., runningSum) / windowSize);
+}
+
+void RunningRMS::startNextChunk() {
+    currentChunk = (currentChunk + 1) % chunkSums.size();
+    samplesInChunk = 0;
+
+    runningSum -= chunkSums[currentChunk];
+    chunkSums[currentChunk] = 0.;
+
+    if (++chunksSinceRecompute >= (int) chunkSums.size()) {
+        runningSum = std::accumulate(chunkSums.begin(), chunkSums.end(), 0.);
+        chunksSinceRecompute = 0;
+    }
+}
+
+size_t RunningRMS::getSizeInBytes() const {
+    return MemoryUsage::getSizeInBytes(chunkSums);
+}
+
+template void RunningRMS::pushSamples<float>(const float*, int);
+template void RunningRMS::pushSamples<double>(const double*, int);
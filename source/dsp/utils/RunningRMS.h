@@ -0,0 +1,36 @@
+#ifndef runningrms_h
+#define runningrms_h
+
+#include <JuceHeader.h>
+
+/*  RMS over a sliding window at a cost proportional to the number of pushed samples.
+ *  The window is split into chunks whose sums of squares are kept in a ring; the running total is
+ *  re-summed from the chunks once per window cycle so it cannot drift.
+ */
+class RunningRMS {
+public:
+    RunningRMS();
+    ~RunningRMS();
+
+    void prepare(int windowSizeInSamples);
+    void reset();
+    void release();
+    template <typename SampleType>
+    void pushSamples(const SampleType* data, int numSamples);
+    float getRMSLevel() const;
+    size_t getSizeInBytes() const;
+
+private:
+    void startNextChunk();
+
+private:
+    std::vector<double> chunkSums;
+    double runningSum = 0.;
+    size_t currentChunk = 0;
+    int samplesInChunk = 0;
+    int chunksSinceRecompute = 0;
+
+    static constexpr int chunkSize = 64;
+};
+
+#endif
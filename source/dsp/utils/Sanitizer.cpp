@@ -0,0 +1,84 @@
+#include "Sanitizer.h"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    // IEEE 754 layout of each sample type, classified through an unsigned integer of the same width
+    template <typename SampleType> struct SampleBits;
+
+    template <> struct SampleBits<float> {
+        using Integer = std::uint32_t;
+        static constexpr Integer exponentMask = 0x7f800000u;
+        static constexpr Integer mantissaMask = 0x007fffffu;
+    };
+
+    template <> struct SampleBits<double> {
+        using Integer = std::uint64_t;
+        static constexpr Integer exponentMask = 0x7ff0000000000000u;
+        static constexpr Integer mantissaMask = 0x000fffffffffffffu;
+    };
+}
+
+Sanitizer::Sanitizer() = default;
+
+Sanitizer::~Sanitizer() = default;
+
+template <typename SampleType>
+SanitizerReport Sanitizer::process(juce::AudioBuffer<SampleType> &buffer) {
+    SanitizerReport report;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        auto channelReport = process(buffer.getWritePointer(channel), buffer.getNumSamples());
+        report.nonFiniteSamples += channelReport.nonFiniteSamples;
+        report.denormalSamples += channelReport.denormalSamples;
+    }
+
+    if (! report.isClean()) {
+        totalNonFiniteSamples.fetch_add(report.nonFiniteSamples, std::memory_order_relaxed);
+        totalDenormalSamples.fetch_add(report.denormalSamples, std::memory_order_relaxed);
+    }
+
+    const bool nonFinite = report.nonFiniteSamples > 0;
+    report.startsNonFiniteEpisode = nonFinite && ! inNonFiniteEpisode;
+    inNonFiniteEpisode = nonFinite;
+
+    return report;
+}
+
+template <typename SampleType>
+SanitizerReport Sanitizer::process(SampleType *data, int numSamples) {
+    using Bits = SampleBits<SampleType>;
+    using Integer = typename Bits::Integer;
+
+    int nonFinite = 0;
+    int denormal = 0;
+
+    for (int i = 0; i < numSamples; ++i) {
+        Integer bits;
+        std::memcpy(&bits, data + i, sizeof(bits));
+        const Integer exponent = bits & Bits::exponentMask;
+
+        // all exponent bits set is Inf or NaN, none set with a mantissa is a denormal
+        const int isNonFinite = exponent == Bits::exponentMask;
+        const int isDenormal = (exponent == 0u) & ((bits & Bits::mantissaMask) != 0u);
+
+        data[i] = (isNonFinite | isDenormal) ? (SampleType) 0 : data[i];
+        nonFinite += isNonFinite;
+        denormal += isDenormal;
+    }
+
+    return {nonFinite, denormal};
+}
+
+int Sanitizer::getTotalNonFiniteSamples() const {
+    return totalNonFiniteSamples.load(std::memory_order_relaxed);
+}
+
+int Sanitizer::getTotalDenormalSamples() const {
+    return totalDenormalSamples.load(std::memory_order_relaxed);
+}
+
+template SanitizerReport Sanitizer::process<float>(juce::AudioBuffer<float>&);
+template SanitizerReport Sanitizer::process<double>(juce::AudioBuffer<double>&);
+template SanitizerReport Sanitizer::process<float>(float*, int);
+template SanitizerReport Sanitizer::process<double>(double*, int);
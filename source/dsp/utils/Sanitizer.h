@@ -0,0 +1,41 @@
+#ifndef sanitizer_h
+#define sanitizer_h
+
+#include <JuceHeader.h>
+
+struct SanitizerReport {
+    int nonFiniteSamples = 0;
+    int denormalSamples = 0;
+    // set on the first block with non-finite samples after a clean one, so a broken stage is logged once
+    bool startsNonFiniteEpisode = false;
+
+    bool isClean() const { return nonFiniteSamples == 0 && denormalSamples == 0; }
+};
+
+/*  Scan-and-repair stage for the boundaries of the signal chain.
+ *  NaN and Inf samples are replaced by silence and denormals are flushed to zero in one branch-free pass that the
+ *  compiler can vectorise. Samples are classified from their bit pattern, float comparisons would treat denormals as
+ *  zero under the DAZ mode that ScopedNoDenormals sets. Counts of everything repaired are kept for diagnostics.
+ */
+class Sanitizer {
+public:
+    Sanitizer();
+    ~Sanitizer();
+
+    template <typename SampleType>
+    SanitizerReport process(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    static SanitizerReport process(SampleType* data, int numSamples);
+
+    int getTotalNonFiniteSamples() const;
+    int getTotalDenormalSamples() const;
+
+private:
+    std::atomic<int> totalNonFiniteSamples {0};
+    std::atomic<int> totalDenormalSamples {0};
+    bool inNonFiniteEpisode = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Sanitizer)
+};
+
+#endif
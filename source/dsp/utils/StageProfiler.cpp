@@ -0,0 +1,111 @@
+#include "StageProfiler.h"
+
+const char* StageProfiler::getStageName(int stage) {
+    switch (stage) {
+        case callback:      return "callback";
+        case parameters:    return "parameters";
+        case inputStage:    return "input";
+        case preProcessing: return "splitters and filters";
+        case visualiser:    return "visualiser";
+        case inference:     return "inference I/O";
+        case levelAnalyser: return "level analysers";
+        case grainDelay:    return "grain delays";
+        case branchOutput:  return "branch output";
+        case networkMixer:  return "network mixer";
+        case compressor:    return "compressor";
+        case outputStage:   return "output stage";
+        default:            return "";
+    }
+}
+
+void StageProfiler::prepare(double newSampleRate) {
+    sampleRate.store(newSampleRate);
+}
+
+void StageProfiler::record(Stage stage, juce::int64 nanoseconds) {
+    auto& histogram = histograms[(size_t) stage];
+    histogram.bins[(size_t) getBin(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    histogram.totalNanoseconds.fetch_add((juce::uint64) juce::jmax((juce::int64) 0, nanoseconds), std::memory_order_relaxed);
+}
+
+void StageProfiler::addProcessedSamples(int numSamples) {
+    processedSamples.fetch_add((juce::uint64) numSamples, std::memory_order_relaxed);
+}
+
+std::vector<StageProfiler::StageStatistics> StageProfiler::collect() {
+    const auto samples = processedSamples.load(std::memory_order_relaxed);
+    const double audioNanoseconds = (double) (samples - previousProcessedSamples) / sampleRate.load() * 1.0e9;
+    previousProcessedSamples = samples;
+
+    std::vector<StageStatistics> statistics;
+    statistics.reserve(numStages);
+
+    for (size_t stage = 0; stage < (size_t) numStages; ++stage) {
+        auto& histogram = histograms[stage];
+        auto& previous = previousSnapshots[stage];
+
+        std::array<juce::uint32, numBins> bins {};
+        juce::int64 count = 0;
+        for (size_t bin = 0; bin < (size_t) numBins; ++bin) {
+            const auto current = histogram.bins[bin].load(std::memory_order_relaxed);
+            bins[bin] = current - previous.bins[bin];
+            previous.bins[bin] = current;
+            count += bins[bin];
+        }
+
+        const auto totalNanoseconds = histogram.totalNanoseconds.load(std::memory_order_relaxed);
+        const auto intervalNanoseconds = totalNanoseconds - previous.totalNanoseconds;
+        previous.totalNanoseconds = totalNanoseconds;
+
+        StageStatistics stageStatistics;
+        stageStatistics.name = getStageName((int) stage);
+        stageStatistics.count = count;
+        stageStatistics.medianInMicroseconds = getPercentile(bins, count, 0.5) * 0.001;
+        stageStatistics.percentile99InMicroseconds = getPercentile(bins, count, 0.99) * 0.001;
+        stageStatistics.shareOfRealTime = audioNanoseconds > 0. ? (double) intervalNanoseconds / audioNanoseconds : 0.;
+        statistics.push_back(stageStatistics);
+    }
+
+    return statistics;
+}
+
+juce::var StageProfiler::toVar(const std::vector<StageStatistics> &statistics) {
+    juce::Array<juce::var> stages;
+    for (const auto& stage : statistics) {
+        auto object = new juce::DynamicObject();
+        object->setProperty("name", stage.name);
+        object->setProperty("count", stage.count);
+        object->setProperty("p50Us", stage.medianInMicroseconds);
+        object->setProperty("p99Us", stage.percentile99InMicroseconds);
+        object->setProperty("shareOfRealTime", stage.shareOfRealTime);
+        stages.add(juce::var(object));
+    }
+    return stages;
+}
+
+int StageProfiler::getBin(juce::int64 nanoseconds) {
+    // the mantissa of frexp is in [0.5, 1), its first two bits below the leading one pick the bin within the octave
+    int exponent;
+    const auto mantissa = std::frexp((float) nanoseconds, &exponent);
+    const int bin = (exponent - 1) * binsPerOctave + (int) ((mantissa - 0.5f) * 2.f * binsPerOctave);
+    return juce::jlimit(0, numBins - 1, bin);
+}
+
+double StageProfiler::getBinCentreInNanoseconds(int bin) {
+    const int exponent = bin / binsPerOctave + 1;
+    const double mantissa = 0.5 + ((double) (bin % binsPerOctave) + 0.5) / (2. * binsPerOctave);
+    return std::ldexp(mantissa, exponent);
+}
+
+double StageProfiler::getPercentile(const std::array<juce::uint32, numBins> &bins, juce::int64 count, double percentile) {
+    if (count == 0) return 0.;
+
+    const auto rank = (juce::int64) std::ceil(percentile * (double) count);
+    juce::int64 cumulative = 0;
+    for (int bin = 0; bin < numBins; ++bin) {
+        cumulative += bins[(size_t) bin];
+        if (cumulative >= rank)
+            return getBinCentreInNanoseconds(bin);
+    }
+    return getBinCentreInNanoseconds(numBins - 1);
+}
@@ -0,0 +1,110 @@
+#ifndef stageprofiler_h
+#define stageprofiler_h
+
+#include <JuceHeader.h>
+
+#ifndef SCYCLONE_PROFILING
+#define SCYCLONE_PROFILING 0
+#endif
+
+/*  Timing of the processing stages on the audio thread.
+ *
+ *  A scoped timer reads the steady clock around a stage and adds the duration to the stage's histogram: four bins
+ *  per octave of nanoseconds, counted with relaxed atomics, so the branch worker can record at the same time as the
+ *  audio thread. The reader diffs the counters against its previous collect and gets the median, the 99th percentile
+ *  and the share of real time of each stage over that interval. Stages that run on both branches add up, with
+ *  parallel branch processing their shares can exceed the callback's.
+ *
+ *  Built with SCYCLONE_PROFILING=0 the timers expand to nothing and the profiler only reports that it is disabled.
+ */
+class StageProfiler {
+public:
+    enum Stage {
+        callback,
+        parameters,
+        inputStage,
+        preProcessing,
+        visualiser,
+        inference,
+        levelAnalyser,
+        grainDelay,
+        branchOutput,
+        networkMixer,
+        compressor,
+        outputStage,
+        numStages
+    };
+
+    struct StageStatistics {
+        juce::String name;
+        juce::int64 count = 0;
+        double medianInMicroseconds = 0.;
+        double percentile99InMicroseconds = 0.;
+        // time spent in the stage per time of audio processed
+        double shareOfRealTime = 0.;
+    };
+
+    static constexpr bool isEnabled() { return SCYCLONE_PROFILING != 0; }
+    static const char* getStageName(int stage);
+
+    void prepare(double newSampleRate);
+
+    // audio thread and branch worker
+    void record(Stage stage, juce::int64 nanoseconds);
+    void addProcessedSamples(int numSamples);
+
+    // reader side, one thread only; statistics since the previous call
+    std::vector<StageStatistics> collect();
+    static juce::var toVar(const std::vector<StageStatistics>& statistics);
+
+    class ScopedTimer {
+    public:
+        ScopedTimer(StageProfiler& p, Stage s) : profiler(p), stage(s), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            const auto duration = std::chrono::steady_clock::now() - start;
+            profiler.record(stage, (juce::int64) std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+
+    private:
+        StageProfiler& profiler;
+        const Stage stage;
+        const std::chrono::steady_clock::time_point start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+    static constexpr int binsPerOctave = 4;
+    // up to 2^27 ns, about 134 ms
+    static constexpr int numOctaves = 27;
+    static constexpr int numBins = binsPerOctave * numOctaves;
+
+private:
+    struct Histogram {
+        std::array<std::atomic<juce::uint32>, numBins> bins {};
+        std::atomic<juce::uint64> totalNanoseconds {0};
+    };
+
+    struct HistogramSnapshot {
+        std::array<juce::uint32, numBins> bins {};
+        juce::uint64 totalNanoseconds = 0;
+    };
+
+    static int getBin(juce::int64 nanoseconds);
+    static double getBinCentreInNanoseconds(int bin);
+    static double getPercentile(const std::array<juce::uint32, numBins>& bins, juce::int64 count, double percentile);
+
+    std::array<Histogram, numStages> histograms;
+    std::atomic<juce::uint64> processedSamples {0};
+    std::atomic<double> sampleRate {48000.};
+
+    std::array<HistogramSnapshot, numStages> previousSnapshots;
+    juce::uint64 previousProcessedSamples = 0;
+};
+
+#if SCYCLONE_PROFILING
+#define SCYCLONE_PROFILE_STAGE(profiler, stage) StageProfiler::ScopedTimer JUCE_JOIN_MACRO (stageTimer, __LINE__) (profiler, stage)
+#else
+#define SCYCLONE_PROFILE_STAGE(profiler, stage)
+#endif
+
+#endif
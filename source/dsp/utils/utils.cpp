@@ -6,6 +6,7 @@
 //
 
 #include "utils.h"
+#include "FastMath.h"
 
 float utils::amp2dB(float amp){
     return 20*std::log10(amp);
@@ -22,3 +23,19 @@ float utils::dB2amp(float db){
 float utils::dB2amp(float db, float ampRef){
     return std::pow(10.f, (db/20.f))*ampRef;
 }
+
+void utils::amp2dB(const float* amp, float* db, int numSamples){
+    // 20 * log10(2)
+    constexpr float dBPerOctave = 6.02059991f;
+    fastLog2(amp, db, numSamples);
+    for (int i = 0; i < numSamples; i++)
+        db[i] *= dBPerOctave;
+}
+
+void utils::dB2amp(const float* db, float* amp, int numSamples){
+    // log2(10) / 20
+    constexpr float octavesPerDecibel = 0.166096405f;
+    for (int i = 0; i < numSamples; i++)
+        amp[i] = db[i] * octavesPerDecibel;
+    fastExp2(amp, amp, numSamples);
+}
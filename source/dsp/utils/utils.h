@@ -15,6 +15,10 @@ namespace utils {
     float amp2dB(float amp, float ampRef);
     float dB2amp(float db);
     float dB2amp(float db, float ampRef);
+
+    // whole blocks on the fast log2/exp2 kernels, see FastMath.h for the error bounds; may run in place
+    void amp2dB(const float* amp, float* db, int numSamples);
+    void dB2amp(const float* db, float* amp, int numSamples);
 }
 
 #endif /* utils_h */
@@ -0,0 +1,107 @@
+#include "DiagnosticsView.h"
+
+DiagnosticsView::DiagnosticsView(AudioPluginAudioProcessor& p) : processorRef(p) {
+    copyButton.onClick = [this] {
+        juce::SystemClipboard::copyTextToClipboard(juce::JSON::toString(createReport()));
+    };
+    addAndMakeVisible(copyButton);
+}
+
+DiagnosticsView::~DiagnosticsView() {
+    stopTimer();
+}
+
+void DiagnosticsView::paint(juce::Graphics &g) {
+    g.fillAll(juce::Colour::fromString(ColorPallete::BG).withAlpha(0.9f));
+
+    g.setColour(juce::Colour::fromString(ColorPallete::KNOB_LABEL));
+    // the timings are columns of numbers
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 13.f, juce::Font::plain));
+
+    auto area = getLocalBounds().reduced(10);
+    area.removeFromTop(copyButton.getHeight() + 5);
+    drawLines(g, performanceLines, area.removeFromLeft(area.getWidth() * 3 / 5));
+    drawLines(g, memoryLines, area);
+}
+
+void DiagnosticsView::resized() {
+    copyButton.setBounds(getLocalBounds().reduced(10).removeFromTop(24).removeFromRight(100));
+}
+
+void DiagnosticsView::visibilityChanged() {
+    if (isVisible()) {
+        update();
+        startTimerHz(refreshRateInHz);
+    } else {
+        stopTimer();
+    }
+}
+
+void DiagnosticsView::timerCallback() {
+    update();
+}
+
+void DiagnosticsView::update() {
+    performanceLines.clear();
+    addProfilerLines();
+
+    const auto sanitizerTotals = processorRef.getSanitizerTotals();
+    performanceLines.add({});
+    performanceLines.add("repaired samples: " + juce::String(sanitizerTotals.nonFiniteSamples) + " non-finite, "
+                         + juce::String(sanitizerTotals.denormalSamples) + " denormal");
+
+    const auto events = processorRef.getEventLogWriter().getRecentLines();
+    performanceLines.add({});
+    performanceLines.add(events.isEmpty() ? "no events" : "recent events:");
+    performanceLines.addArray(events);
+
+    memoryLines = processorRef.getMemoryUsage().toLines();
+
+    repaint();
+}
+
+void DiagnosticsView::addProfilerLines() {
+    performanceLines.add("inference queue: " + juce::String(inferencePool->getNumJobs()) + " jobs");
+
+    if (! StageProfiler::isEnabled()) {
+        performanceLines.add("stage profiling is disabled in this build");
+        return;
+    }
+
+    stageStatistics = processorRef.getStageProfiler().collect();
+    performanceLines.add(juce::String::formatted("%-22s %9s %9s %7s", "stage", "p50 us", "p99 us", "load"));
+    for (const auto& stage : stageStatistics) {
+        performanceLines.add(juce::String::formatted("%-22s %9.1f %9.1f %6.1f%%",
+                                                     stage.name.toRawUTF8(),
+                                                     stage.medianInMicroseconds,
+                                                     stage.percentile99InMicroseconds,
+                                                     stage.shareOfRealTime * 100.));
+    }
+}
+
+void DiagnosticsView::drawLines(juce::Graphics &g, const juce::StringArray &linesToDraw, juce::Rectangle<int> area) {
+    for (const auto& line : linesToDraw) {
+        if (area.getHeight() < lineHeight) break;
+        g.drawText(line, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+    }
+}
+
+juce::var DiagnosticsView::createReport() const {
+    const auto sanitizerTotals = processorRef.getSanitizerTotals();
+    auto sanitizer = new juce::DynamicObject();
+    sanitizer->setProperty("nonFiniteSamples", sanitizerTotals.nonFiniteSamples);
+    sanitizer->setProperty("denormalSamples", sanitizerTotals.denormalSamples);
+
+    auto report = new juce::DynamicObject();
+    report->setProperty("memory", processorRef.getMemoryUsage().toVar());
+    report->setProperty("sanitizer", juce::var(sanitizer));
+    report->setProperty("inferenceQueueDepth", inferencePool->getNumJobs());
+    if (StageProfiler::isEnabled())
+        report->setProperty("stages", StageProfiler::toVar(stageStatistics));
+
+    juce::Array<juce::var> events;
+    for (const auto& line : processorRef.getEventLogWriter().getRecentLines())
+        events.add(line);
+    report->setProperty("events", events);
+    return juce::var(report);
+}
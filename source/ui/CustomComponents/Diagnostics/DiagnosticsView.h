@@ -0,0 +1,44 @@
+#ifndef VAESYNTH_DIAGNOSTICSVIEW_H
+#define VAESYNTH_DIAGNOSTICSVIEW_H
+
+#include <JuceHeader.h>
+#include "../../../PluginProcessor.h"
+#include "../../../dsp/onnx/InferencePool.h"
+#include "../../../utils/colors.h"
+
+/*  Overlay with the internals of the instance. The left column has the stage timings of the last second, the depth
+ *  of the shared inference queue, the repaired samples and the latest diagnostic events; the right column has the
+ *  memory per subsystem. Refreshed once per second while visible, the copy button puts the same report on the
+ *  clipboard as JSON.
+ */
+class DiagnosticsView : public juce::Component, private juce::Timer {
+public:
+    explicit DiagnosticsView(AudioPluginAudioProcessor& p);
+    ~DiagnosticsView() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+    void update();
+    void addProfilerLines();
+    juce::var createReport() const;
+    static void drawLines(juce::Graphics& g, const juce::StringArray& linesToDraw, juce::Rectangle<int> area);
+
+    AudioPluginAudioProcessor& processorRef;
+    juce::SharedResourcePointer<InferencePool> inferencePool;
+    juce::TextButton copyButton {"Copy JSON"};
+
+    std::vector<StageProfiler::StageStatistics> stageStatistics;
+    juce::StringArray performanceLines;
+    juce::StringArray memoryLines;
+
+    static constexpr int refreshRateInHz = 1;
+    static constexpr int lineHeight = 16;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagnosticsView)
+};
+
+#endif //VAESYNTH_DIAGNOSTICSVIEW_H
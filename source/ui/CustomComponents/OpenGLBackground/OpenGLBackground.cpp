@@ -32,8 +32,6 @@ OpenGLBackground::OpenGLBackground(juce::AudioProcessorValueTreeState& parameter
     xyPad.onModelMixChange = [this](float modelMix){this->xyModelMixChanged(modelMix);};
     SetJuceLabels();
     addAndMakeVisible(openGlTextureComponent);
-    
-    processorRef.setLevelType(PEAK);
 
     resolution_juce.add((float) getWidth());
     resolution_juce.add((float) getHeight());
@@ -116,12 +114,13 @@ void OpenGLBackground::renderOpenGL()
     if (modelMix) modelMix->set(modelMix_juce);
     if (knobPos1) knobPos1->set(knobPos1_juce.xPosition,knobPos1_juce.yPosition);
     if (knobPos2) knobPos2->set(knobPos2_juce.xPosition,knobPos2_juce.yPosition);
+    const auto meterTime = juce::Time::getMillisecondCounterHiRes();
     if (audioLevel1){
-        audioLevel1_juce = processorRef.getCurrentLevel(1);
+        audioLevel1_juce = levelMeter1.update(processorRef.getLevelAnalyser(1), meterTime);
         audioLevel1->set(static_cast<GLfloat>(audioLevel1_juce));
     }
     if (audioLevel2){
-        audioLevel2_juce = processorRef.getCurrentLevel(2);
+        audioLevel2_juce = levelMeter2.update(processorRef.getLevelAnalyser(2), meterTime);
         audioLevel2->set(static_cast<GLfloat>(audioLevel2_juce));
     }
     
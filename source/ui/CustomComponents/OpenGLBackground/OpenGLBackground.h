@@ -15,6 +15,7 @@
 #include "../../LookAndFeel/CustomFontLookAndFeel.h"
 #include"../XYPad/XYPad.h"
 #include "../../../PluginProcessor.h"
+#include "../../../dsp/analyser/LevelMeter.h"
 
 struct KnobPos {
     float xPosition;
@@ -95,6 +96,8 @@ private:
     juce::Colour backgroundColor_juce;
     float audioLevel1_juce;
     float audioLevel2_juce;
+    LevelMeter levelMeter1 {PEAK};
+    LevelMeter levelMeter2 {PEAK};
     AudioPluginAudioProcessor& processorRef;
     
     // GUI Mouse Drag Interaction
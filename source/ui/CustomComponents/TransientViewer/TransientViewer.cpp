@@ -1,7 +1,7 @@
 #include "TransientViewer.h"
 
-TransientViewer::TransientViewer(AudioPluginAudioProcessor& p) : waveViewerNetwork1(p.getAudioVisualiser1()),
-                                                                 waveViewerNetwork2(p.getAudioVisualiser2())
+TransientViewer::TransientViewer(AudioPluginAudioProcessor& p) : waveViewerNetwork1(p.getAudioVisualiser(), 1),
+                                                                 waveViewerNetwork2(p.getAudioVisualiser(), 2)
 {
     addAndMakeVisible(waveViewerNetwork1);
     addAndMakeVisible(waveViewerNetwork2);
@@ -2,6 +2,7 @@
 #include "../../../utils/colors.h"
 #include "../../../PluginProcessor.h"
 #include "TransientGrid.h"
+#include "WaveformViewer.h"
 
 class TransientViewer : public juce::Component
 {
@@ -13,7 +14,7 @@ public:
 	void resized() override;
 
 private:
-    juce::AudioVisualiserComponent& waveViewerNetwork1;
-    juce::AudioVisualiserComponent& waveViewerNetwork2;
+    WaveformViewer waveViewerNetwork1;
+    WaveformViewer waveViewerNetwork2;
     TransientGrid transientGrid;
 };
\ No newline at end of file
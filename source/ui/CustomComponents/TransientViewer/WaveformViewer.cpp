@@ -0,0 +1,53 @@
+#include "WaveformViewer.h"
+
+WaveformViewer::WaveformViewer(AudioVisualiser& visualiser, int networkNumber) : audioVisualiser(visualiser),
+                                                                                 number(networkNumber),
+                                                                                 incoming((size_t) AudioVisualiser::ringSize)
+{
+    setOpaque(true);
+    startTimerHz(refreshRateInHz);
+}
+
+WaveformViewer::~WaveformViewer() {
+    stopTimer();
+}
+
+void WaveformViewer::setColours(juce::Colour newBackgroundColour, juce::Colour newWaveformColour) {
+    backgroundColour = newBackgroundColour;
+    waveformColour = newWaveformColour;
+    repaint();
+}
+
+void WaveformViewer::paint(juce::Graphics &g) {
+    g.fillAll(backgroundColour);
+    if (history.empty()) return;
+
+    g.setColour(waveformColour);
+    const auto height = (float) getHeight();
+    const auto centre = height * 0.5f;
+
+    // oldest column on the left, at most one pixel column each
+    for (size_t x = 0; x < history.size(); ++x) {
+        const auto& column = history[(historyPosition + x) % history.size()];
+        const float top = centre - juce::jlimit(-1.f, 1.f, column.maximum) * centre;
+        const float bottom = centre - juce::jlimit(-1.f, 1.f, column.minimum) * centre;
+        g.fillRect((float) x, top, 1.f, juce::jmax(1.f, bottom - top));
+    }
+}
+
+void WaveformViewer::resized() {
+    history.assign((size_t) juce::jmax(1, getWidth()), WaveformColumn {});
+    historyPosition = 0;
+    audioVisualiser.setNumColumns(number, (int) history.size());
+}
+
+void WaveformViewer::timerCallback() {
+    const int numColumns = audioVisualiser.readColumns(number, incoming.data(), (int) incoming.size());
+    if (numColumns == 0 || history.empty()) return;
+
+    for (int i = 0; i < numColumns; ++i) {
+        history[historyPosition] = incoming[(size_t) i];
+        historyPosition = (historyPosition + 1) % history.size();
+    }
+    repaint();
+}
@@ -0,0 +1,38 @@
+#ifndef VAESYNTH_WAVEFORMVIEWER_H
+#define VAESYNTH_WAVEFORMVIEWER_H
+
+#include <JuceHeader.h>
+#include "../../../dsp/analyser/AudioVisualiser.h"
+
+/*  Scrolling min/max waveform of one network. The columns arrive already decimated to one per pixel, so the viewer
+ *  keeps them in a ring and paints one bar per column. It only repaints when new columns have arrived.
+ */
+class WaveformViewer : public juce::Component, private juce::Timer {
+public:
+    WaveformViewer(AudioVisualiser& visualiser, int networkNumber);
+    ~WaveformViewer() override;
+
+    void setColours(juce::Colour newBackgroundColour, juce::Colour newWaveformColour);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    AudioVisualiser& audioVisualiser;
+    const int number;
+
+    std::vector<WaveformColumn> history;
+    std::vector<WaveformColumn> incoming;
+    size_t historyPosition = 0;
+
+    juce::Colour backgroundColour;
+    juce::Colour waveformColour;
+
+    static constexpr int refreshRateInHz = 30;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformViewer)
+};
+
+#endif //VAESYNTH_WAVEFORMVIEWER_H
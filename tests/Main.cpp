@@ -0,0 +1,17 @@
+/*  Runs every juce::UnitTest linked into the test app, the exit code is the number of failed checks.
+ *  Built with -DSCYCLONE_BUILD_TESTS=ON and run through ctest.
+ */
+#include <JuceHeader.h>
+
+int main() {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runAllTests();
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+    return numFailures;
+}
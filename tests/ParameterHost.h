@@ -0,0 +1,34 @@
+#ifndef VAESYNTH_PARAMETERHOST_H
+#define VAESYNTH_PARAMETERHOST_H
+
+#include <JuceHeader.h>
+#include "PluginParameters.h"
+
+/*  An AudioProcessor that only holds the plugin parameters, for the stages that read their defaults from the
+ *  AudioProcessorValueTreeState.
+ */
+class ParameterHost : public juce::AudioProcessor {
+public:
+    ParameterHost() : parameters(*this, nullptr, "PARAMETERS", PluginParameters::createParameterLayout()) {}
+
+    const juce::String getName() const override { return "ParameterHost"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    double getTailLengthSeconds() const override { return 0.; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+    juce::AudioProcessorValueTreeState parameters;
+};
+
+#endif //VAESYNTH_PARAMETERHOST_H
@@ -0,0 +1,97 @@
+#include <JuceHeader.h>
+#include "ParameterHost.h"
+#include "dsp/networkSlot/PreProcessingLanes.h"
+
+class PreProcessingLanesTest : public juce::UnitTest {
+public:
+    PreProcessingLanesTest() : juce::UnitTest("PreProcessingLanes", "Scyclone") {}
+
+    void runTest() override {
+        // the float lanes and the per-network double path have to route the same way
+        runRoutingTests<float>("float");
+        runRoutingTests<double>("double");
+    }
+
+private:
+    template <typename SampleType>
+    void runRoutingTests(const juce::String& precision) {
+        beginTest("an idle first network does not silence the input of the second one (" + precision + ")");
+        {
+            // the main bus is the bus of network 1, like in the RoutingGraph
+            const auto levels = process<SampleType>({false, true});
+            expectEquals(levels[0], 0.f);
+            expectGreaterThan(levels[1], minLevel);
+        }
+
+        beginTest("an idle second network gets a silent bus (" + precision + ")");
+        {
+            const auto levels = process<SampleType>({true, false});
+            expectGreaterThan(levels[0], minLevel);
+            expectEquals(levels[1], 0.f);
+        }
+
+        beginTest("both networks get the signal (" + precision + ")");
+        {
+            const auto levels = process<SampleType>({true, true});
+            expectGreaterThan(levels[0], minLevel);
+            expectGreaterThan(levels[1], minLevel);
+        }
+    }
+
+    // RMS level of every network bus after the last block
+    template <typename SampleType>
+    std::array<float, PluginParameters::NUM_NETWORKS> process(const std::array<bool, PluginParameters::NUM_NETWORKS>& processing) {
+        ParameterHost host;
+        const juce::dsp::ProcessSpec spec {sampleRate, (juce::uint32) blockSize, 1};
+
+        std::vector<std::unique_ptr<TransientSplitter<SampleType>>> splitters;
+        std::vector<std::unique_ptr<IIRCutoffFilter<SampleType>>> filters;
+        std::vector<juce::AudioBuffer<SampleType>> ownBuses;
+        PreProcessingLanes::Networks<SampleType> networks;
+        PreProcessingLanes::Buses<SampleType> buses;
+
+        juce::AudioBuffer<SampleType> mainBus(1, blockSize);
+        for (size_t i = 0; i < networks.size(); ++i) {
+            splitters.push_back(std::make_unique<TransientSplitter<SampleType>>());
+            filters.push_back(std::make_unique<IIRCutoffFilter<SampleType>>(host.parameters, (int) i + 1));
+            // the centre position is neither low- nor high-passed, so the test tone passes at full level
+            filters.back()->updateFilterParams(0.5f);
+            splitters.back()->prepare(spec);
+            filters.back()->prepare(spec);
+            networks[i] = {splitters.back().get(), filters.back().get(), processing[i]};
+        }
+
+        ownBuses.resize(networks.size());
+        buses[0] = &mainBus;
+        for (size_t i = 1; i < networks.size(); ++i) {
+            ownBuses[i].setSize(1, blockSize);
+            buses[i] = &ownBuses[i];
+        }
+
+        PreProcessingLanes lanes;
+        lanes.prepare(blockSize);
+
+        int position = 0;
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int sample = 0; sample < blockSize; ++sample, ++position)
+                mainBus.setSample(0, sample, (SampleType) (0.5f * std::sin(juce::MathConstants<float>::twoPi * frequency * (float) position / (float) sampleRate)));
+            for (size_t i = 1; i < networks.size(); ++i)
+                buses[i]->clear();
+
+            lanes.process(networks, mainBus, buses);
+        }
+
+        std::array<float, PluginParameters::NUM_NETWORKS> levels {};
+        for (size_t i = 0; i < networks.size(); ++i)
+            levels[i] = (float) buses[i]->getRMSLevel(0, 0, blockSize);
+        return levels;
+    }
+
+    static constexpr double sampleRate = 48000.;
+    static constexpr int blockSize = 128;
+    static constexpr int numBlocks = 40;
+    static constexpr float frequency = 1000.f;
+    static constexpr float minLevel = 0.25f;
+};
+
+static PreProcessingLanesTest preProcessingLanesTest;
@@ -0,0 +1,104 @@
+#include <JuceHeader.h>
+#include "dsp/utils/Sanitizer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+class SanitizerTest : public juce::UnitTest {
+public:
+    SanitizerTest() : juce::UnitTest("Sanitizer", "Scyclone") {}
+
+    void runTest() override {
+        // the processor sanitizes with DAZ set, so must the test
+        juce::ScopedNoDenormals noDenormals;
+
+        beginTest("denormals are counted and flushed");
+        {
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            fill(buffer, fromBits(0x00000001u));
+            buffer.setSample(0, 1, -fromBits(0x007fffffu));
+            buffer.setSample(0, 2, std::numeric_limits<float>::min());
+
+            Sanitizer sanitizer;
+            const auto report = sanitizer.process(buffer);
+            expectEquals(report.denormalSamples, blockSize - 1);
+            expectEquals(report.nonFiniteSamples, 0);
+            expectEquals(toBits(buffer.getSample(0, 0)), 0u);
+            expectEquals(buffer.getSample(0, 2), std::numeric_limits<float>::min());
+        }
+
+        beginTest("NaN and Inf are replaced by silence");
+        {
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            fill(buffer, 0.5f);
+            buffer.setSample(0, 3, std::numeric_limits<float>::quiet_NaN());
+            buffer.setSample(0, 4, -std::numeric_limits<float>::infinity());
+
+            Sanitizer sanitizer;
+            const auto report = sanitizer.process(buffer);
+            expectEquals(report.nonFiniteSamples, 2);
+            expectEquals(buffer.getSample(0, 3), 0.f);
+            expectEquals(buffer.getSample(0, 4), 0.f);
+            expectEquals(buffer.getSample(0, 5), 0.5f);
+        }
+
+        beginTest("a run of broken blocks starts one episode");
+        {
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            Sanitizer sanitizer;
+            int numEpisodes = 0;
+
+            for (int block = 0; block < 10; ++block) {
+                // blocks 2 to 5 and 8 are broken
+                const bool broken = (block >= 2 && block <= 5) || block == 8;
+                fill(buffer, broken ? std::numeric_limits<float>::quiet_NaN() : 0.5f);
+                numEpisodes += sanitizer.process(buffer).startsNonFiniteEpisode ? 1 : 0;
+            }
+
+            expectEquals(numEpisodes, 2);
+            expectEquals(sanitizer.getTotalNonFiniteSamples(), 5 * blockSize);
+        }
+
+        beginTest("double samples are classified with the double layout");
+        {
+            // 1e-40 is a float denormal but a normal double, and must survive
+            juce::AudioBuffer<double> buffer(1, 4);
+            buffer.setSample(0, 0, std::numeric_limits<double>::denorm_min());
+            buffer.setSample(0, 1, 1e-40);
+            buffer.setSample(0, 2, std::numeric_limits<double>::quiet_NaN());
+            buffer.setSample(0, 3, 0.5);
+
+            Sanitizer sanitizer;
+            const auto report = sanitizer.process(buffer);
+            expectEquals(report.denormalSamples, 1);
+            expectEquals(report.nonFiniteSamples, 1);
+            expectEquals(buffer.getSample(0, 0), 0.);
+            expectEquals(buffer.getSample(0, 1), 1e-40);
+            expectEquals(buffer.getSample(0, 2), 0.);
+            expectEquals(buffer.getSample(0, 3), 0.5);
+        }
+    }
+
+private:
+    static float fromBits(std::uint32_t bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static std::uint32_t toBits(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static void fill(juce::AudioBuffer<float>& buffer, float value) {
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(0, i, value);
+    }
+
+    static constexpr int blockSize = 64;
+};
+
+static SanitizerTest sanitizerTest;